@@ -0,0 +1,181 @@
+#include "stable_vector.h"
+
+#include <boost/container/stable_vector.hpp>
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <random>
+#include <vector>
+
+// Microbenchmarks for the container hot paths: sequential iteration, random
+// operator[], push_back growth, copy construction and reserve+fill, across
+// chunk sizes and element sizes, with std::vector, std::deque and
+// boost::container::stable_vector as baselines.
+
+template <std::size_t Bytes>
+struct element
+{
+	element(int v = 0) : data{}
+	{
+		data[0] = v;
+	}
+
+	int data[Bytes / sizeof(int)];
+};
+
+static long value_of(int v) { return v; }
+
+template <std::size_t Bytes>
+static long value_of(const element<Bytes>& e) { return e.data[0]; }
+
+template <class Container>
+static Container make_filled(std::size_t n)
+{
+	Container v;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		v.push_back(typename Container::value_type(1));
+	}
+
+	return v;
+}
+
+template <class Container>
+static void iteration(benchmark::State& state)
+{
+	const auto v = make_filled<Container>(static_cast<std::size_t>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		long sum = 0;
+		for (const auto& e : v)
+		{
+			sum += value_of(e);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Container>
+static void random_access(benchmark::State& state)
+{
+	const std::size_t n = static_cast<std::size_t>(state.range(0));
+	const auto v = make_filled<Container>(n);
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+	std::vector<std::size_t> indices(n);
+	for (auto& i : indices)
+	{
+		i = dist(rng);
+	}
+
+	for (auto _ : state)
+	{
+		long sum = 0;
+		for (const std::size_t i : indices)
+		{
+			sum += value_of(v[i]);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Container>
+static void push_back_growth(benchmark::State& state)
+{
+	const std::size_t n = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state)
+	{
+		Container v;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			v.push_back(typename Container::value_type(1));
+		}
+		benchmark::DoNotOptimize(v);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Container>
+static void copy_construction(benchmark::State& state)
+{
+	const auto v = make_filled<Container>(static_cast<std::size_t>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		Container copy(v);
+		benchmark::DoNotOptimize(copy);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Only for containers with reserve(); std::deque and boost's stable_vector
+// don't have one.
+template <class Container>
+static void reserve_and_fill(benchmark::State& state)
+{
+	const std::size_t n = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state)
+	{
+		Container v;
+		v.reserve(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			v.push_back(typename Container::value_type(1));
+		}
+		benchmark::DoNotOptimize(v);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+constexpr int small_count = 1 << 20; // 4B and 64B elements
+constexpr int large_count = 1 << 16; // 256B elements
+
+#define CHUNK_SIZE_BENCHMARKS(op)                                                   \
+	BENCHMARK_TEMPLATE(op, stable_vector<int, 256>)->Arg(small_count);              \
+	BENCHMARK_TEMPLATE(op, stable_vector<int, 1024>)->Arg(small_count);             \
+	BENCHMARK_TEMPLATE(op, stable_vector<int, 4096>)->Arg(small_count);             \
+	BENCHMARK_TEMPLATE(op, stable_vector<int, 16384>)->Arg(small_count)
+
+#define ELEMENT_SIZE_BENCHMARKS(op)                                                 \
+	BENCHMARK_TEMPLATE(op, stable_vector<element<64>, 4096>)->Arg(small_count);     \
+	BENCHMARK_TEMPLATE(op, stable_vector<element<256>, 4096>)->Arg(large_count)
+
+#define BASELINE_BENCHMARKS(op)                                                     \
+	BENCHMARK_TEMPLATE(op, std::vector<int>)->Arg(small_count);                     \
+	BENCHMARK_TEMPLATE(op, std::deque<int>)->Arg(small_count);                      \
+	BENCHMARK_TEMPLATE(op, boost::container::stable_vector<int>)->Arg(small_count)
+
+CHUNK_SIZE_BENCHMARKS(iteration);
+ELEMENT_SIZE_BENCHMARKS(iteration);
+BASELINE_BENCHMARKS(iteration);
+
+CHUNK_SIZE_BENCHMARKS(random_access);
+ELEMENT_SIZE_BENCHMARKS(random_access);
+BASELINE_BENCHMARKS(random_access);
+
+CHUNK_SIZE_BENCHMARKS(push_back_growth);
+ELEMENT_SIZE_BENCHMARKS(push_back_growth);
+BASELINE_BENCHMARKS(push_back_growth);
+
+CHUNK_SIZE_BENCHMARKS(copy_construction);
+ELEMENT_SIZE_BENCHMARKS(copy_construction);
+BASELINE_BENCHMARKS(copy_construction);
+
+BENCHMARK_TEMPLATE(reserve_and_fill, stable_vector<int, 256>)->Arg(small_count);
+BENCHMARK_TEMPLATE(reserve_and_fill, stable_vector<int, 1024>)->Arg(small_count);
+BENCHMARK_TEMPLATE(reserve_and_fill, stable_vector<int, 4096>)->Arg(small_count);
+BENCHMARK_TEMPLATE(reserve_and_fill, stable_vector<int, 16384>)->Arg(small_count);
+BENCHMARK_TEMPLATE(reserve_and_fill, std::vector<int>)->Arg(small_count);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <type_traits>
+#include <array>
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <thread>
+
+#define likely_false(x) __builtin_expect((x), 0)
+#define likely_true(x)  __builtin_expect((x), 1)
+
+// Multi-producer append-only companion to stable_vector. Producers claim a
+// slot with one fetch-add on the cursor, install missing chunks with a CAS
+// (the loser frees its allocation), construct in place and then publish by
+// advancing the size counter once every lower slot is published. Readers are
+// wait-free: size() is an acquire load and operator[] is two dependent loads
+// through a fixed directory, so published elements can be indexed and
+// iterated while producers keep appending. Addresses of published elements
+// never change.
+//
+// The directory is a static array of blocks where block b holds 2^b chunk
+// pointers, so no resize (and no lock) is ever needed at the top level.
+//
+// Not supported concurrently: destruction, and reading slots at or above
+// size(). The destructor assumes all producers are done. Element
+// construction must not throw (enforced per call): a throwing constructor
+// would leave its claimed slot forever unpublished — deadlocking every later
+// producer — and the destructor would tear down a slot that never held an
+// element.
+template <class T, std::size_t ChunkSize = 1024>
+class concurrent_stable_vector
+{
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+private:
+	template <std::size_t N>
+	struct is_pow2 { static constexpr bool value = (N & (N - 1)) == 0; };
+
+	static_assert(is_pow2<ChunkSize>::value, "ChunkSize needs to be a power of 2");
+
+	static constexpr const std::size_t directory_size = 64;
+
+	using chunk_slot = std::atomic<T*>;
+
+public:
+	concurrent_stable_vector() :
+		m_cursor(0),
+		m_size(0)
+	{
+		for (auto& entry : m_directory)
+		{
+			entry.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	concurrent_stable_vector(const concurrent_stable_vector&) = delete;
+	concurrent_stable_vector& operator=(const concurrent_stable_vector&) = delete;
+
+	~concurrent_stable_vector()
+	{
+		const size_type count = m_cursor.load(std::memory_order_acquire);
+		for (size_type i = 0; i < count; ++i)
+		{
+			element(i)->~T();
+		}
+
+		for (std::size_t b = 0; b < directory_size; ++b)
+		{
+			chunk_slot* slots = m_directory[b].load(std::memory_order_acquire);
+			if (!slots)
+			{
+				continue;
+			}
+
+			const std::size_t entries = std::size_t(1) << b;
+			for (std::size_t i = 0; i < entries; ++i)
+			{
+				T* data = slots[i].load(std::memory_order_relaxed);
+				if (data)
+				{
+					::operator delete(data);
+				}
+			}
+
+			delete[] slots;
+		}
+	}
+
+	size_type push_back(const T& t) { return emplace_back(t); }
+	size_type push_back(T&& t)      { return emplace_back(std::move(t)); }
+
+	// Returns the index the element was published at.
+	template <class... Args>
+	size_type emplace_back(Args&&... args)
+	{
+		static_assert(std::is_nothrow_constructible<T, Args&&...>::value,
+					  "concurrent_stable_vector element construction must not throw: a throwing "
+					  "constructor would leave its claimed slot unpublished and deadlock later producers");
+
+		const size_type index = m_cursor.fetch_add(1, std::memory_order_relaxed);
+
+		T* slot = chunk(index / ChunkSize) + index % ChunkSize;
+		::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+
+		publish(index);
+		return index;
+	}
+
+	size_type size() const noexcept { return m_size.load(std::memory_order_acquire); }
+	bool empty() const noexcept { return size() == 0; }
+
+	reference operator[](size_type i) { return *element(i); }
+	const_reference operator[](size_type i) const { return *element(i); }
+
+private:
+	// Chunk c lives in block b = floor(log2(c + 1)) at offset c + 1 - 2^b.
+	static std::size_t block_of(std::size_t chunk_index)
+	{
+		return static_cast<std::size_t>(63 - __builtin_clzll(chunk_index + 1));
+	}
+
+	T* element(size_type i) const
+	{
+		const std::size_t chunk_index = i / ChunkSize;
+		const std::size_t b = block_of(chunk_index);
+		chunk_slot* slots = m_directory[b].load(std::memory_order_acquire);
+		T* data = slots[chunk_index + 1 - (std::size_t(1) << b)].load(std::memory_order_acquire);
+		return data + i % ChunkSize;
+	}
+
+	chunk_slot* block(std::size_t b)
+	{
+		chunk_slot* existing = m_directory[b].load(std::memory_order_acquire);
+		if (likely_true(existing != nullptr))
+		{
+			return existing;
+		}
+
+		// Value-initialized so every slot starts out null.
+		chunk_slot* fresh = new chunk_slot[std::size_t(1) << b]();
+		if (!m_directory[b].compare_exchange_strong(existing, fresh, std::memory_order_acq_rel))
+		{
+			delete[] fresh;
+			return existing;
+		}
+
+		return fresh;
+	}
+
+	T* chunk(std::size_t chunk_index)
+	{
+		const std::size_t b = block_of(chunk_index);
+		chunk_slot& slot = block(b)[chunk_index + 1 - (std::size_t(1) << b)];
+
+		T* existing = slot.load(std::memory_order_acquire);
+		if (likely_true(existing != nullptr))
+		{
+			return existing;
+		}
+
+		T* fresh = static_cast<T*>(::operator new(sizeof(T) * ChunkSize));
+		if (!slot.compare_exchange_strong(existing, fresh, std::memory_order_acq_rel))
+		{
+			::operator delete(fresh);
+			return existing;
+		}
+
+		return fresh;
+	}
+
+	// Slots publish in index order: wait for every lower slot, then advance.
+	// Readers acquire m_size, so everything written up to index is visible.
+	// The spin load must be an acquire too: it is what chains one producer's
+	// release store to the next, so the store of index + 1 carries every
+	// predecessor's element writes — with a relaxed load a reader acquiring
+	// index + 1 would synchronize only with the last producer and could see
+	// stale bytes for earlier elements on weakly-ordered hardware.
+	// Yield after a short spin so a waiting producer can't starve the one
+	// it is waiting on when threads outnumber cores.
+	void publish(size_type index)
+	{
+		std::size_t spins = 0;
+		while (m_size.load(std::memory_order_acquire) != index)
+		{
+			if (++spins > 64)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		m_size.store(index + 1, std::memory_order_release);
+	}
+
+	std::array<std::atomic<chunk_slot*>, directory_size> m_directory;
+	std::atomic<size_type> m_cursor;
+	std::atomic<size_type> m_size;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "stable_vector.h"
+
+#include <atomic>
+
+// Single-writer companion that lets readers scan concurrently with appends,
+// without locks. The writer appends into a plain stable_vector and then
+// publishes the new element count with one release store; stable_prefix()
+// takes one acquire load and returns a count/range over the published
+// elements that stays valid for the whole scan — published chunks are
+// immutable and their addresses never change.
+//
+// Readers cannot go through the inner container's own table: it is a vector
+// that reallocates on growth, racing with an unlocked reader. Instead the
+// writer mirrors each chunk's data pointer into a fixed directory of blocks
+// (block b holds 2^b entries, as in concurrent_stable_vector), which never
+// moves. The directory needs no atomics of its own: every entry is written
+// once, before the release store that publishes the elements it covers, so
+// the acquire on the count makes it visible — readers never touch an entry
+// the count does not cover.
+//
+// One writer thread (serialize writers externally), any number of readers.
+// Append-only by design: erase and pop would un-publish elements out from
+// under a running scan, so they are not offered.
+template <class T, std::size_t ChunkSize = 1024, class Allocator = std::allocator<T>>
+class single_writer_stable_vector
+{
+public:
+	using value_type = T;
+	using const_reference = const T&;
+	using const_pointer = const T*;
+	using size_type = std::size_t;
+
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+	single_writer_stable_vector() = default;
+
+	single_writer_stable_vector(const single_writer_stable_vector&) = delete;
+	single_writer_stable_vector& operator=(const single_writer_stable_vector&) = delete;
+
+	~single_writer_stable_vector()
+	{
+		for (const_pointer* block : m_blocks)
+		{
+			delete[] block;
+		}
+	}
+
+	// Writer side.
+	void push_back(const T& t) { emplace_back(t); }
+	void push_back(T&& t)      { emplace_back(std::move(t)); }
+
+	template <class... Args>
+	void emplace_back(Args&&... args)
+	{
+		const size_type index = m_container.size();
+		m_container.emplace_back(std::forward<Args>(args)...);
+
+		if (likely_false(index % ChunkSize == 0))
+		{
+			install_chunk(index / ChunkSize, &m_container[index]);
+		}
+
+		m_published.store(index + 1, std::memory_order_release);
+	}
+
+	void reserve(size_type new_capacity) { m_container.reserve(new_capacity); }
+
+	// The inner container, for the writer thread only: anything beyond
+	// appends breaks the published prefix.
+	const stable_vector<T, ChunkSize, Allocator>& container() const noexcept { return m_container; }
+
+	// Reader side: all wait-free, one acquire load each.
+	size_type size() const noexcept { return m_published.load(std::memory_order_acquire); }
+	bool empty() const noexcept { return size() == 0; }
+
+	const_reference operator[](size_type i) const { return *element(i); }
+
+	// The published elements at one consistent count; iterate it freely
+	// while the writer keeps appending.
+	class stable_prefix_type
+	{
+	public:
+		struct const_iterator
+		{
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using reference = const T&;
+			using pointer = const T*;
+			using difference_type = std::ptrdiff_t;
+
+			const_reference operator*() const { return (*m_container)[m_index]; }
+			const_pointer operator->() const { return &operator*(); }
+
+			const_iterator& operator++() { ++m_index; return *this; }
+			const_iterator operator++(int) { auto it = *this; ++m_index; return it; }
+
+			bool operator==(const const_iterator& it) const { return m_index == it.m_index; }
+			bool operator!=(const const_iterator& it) const { return !operator==(it); }
+
+			const single_writer_stable_vector* m_container;
+			size_type m_index;
+		};
+
+		size_type size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+
+		const_reference operator[](size_type i) const { return (*m_container)[i]; }
+
+		const_reference front() const { return operator[](0); }
+		const_reference back() const { return operator[](m_size - 1); }
+
+		const_iterator begin() const noexcept { return {m_container, 0}; }
+		const_iterator end() const noexcept { return {m_container, m_size}; }
+
+	private:
+		friend class single_writer_stable_vector;
+
+		stable_prefix_type(const single_writer_stable_vector* container, size_type count) :
+			m_container(container),
+			m_size(count)
+		{}
+
+		const single_writer_stable_vector* m_container;
+		size_type m_size;
+	};
+
+	stable_prefix_type stable_prefix() const noexcept { return {this, size()}; }
+
+private:
+	static constexpr const std::size_t directory_size = 64;
+
+	// Chunk c lives in block b = floor(log2(c + 1)) at offset c + 1 - 2^b.
+	static std::size_t block_of(std::size_t chunk_index)
+	{
+		return static_cast<std::size_t>(63 - __builtin_clzll(chunk_index + 1));
+	}
+
+	void install_chunk(std::size_t chunk_index, const_pointer data)
+	{
+		const std::size_t b = block_of(chunk_index);
+		if (!m_blocks[b])
+		{
+			m_blocks[b] = new const_pointer[std::size_t(1) << b];
+		}
+
+		m_blocks[b][chunk_index + 1 - (std::size_t(1) << b)] = data;
+	}
+
+	const_pointer element(size_type i) const
+	{
+		const std::size_t chunk_index = i / ChunkSize;
+		const std::size_t b = block_of(chunk_index);
+		return m_blocks[b][chunk_index + 1 - (std::size_t(1) << b)] + i % ChunkSize;
+	}
+
+	stable_vector<T, ChunkSize, Allocator> m_container;
+	const_pointer* m_blocks[directory_size] = {};
+	std::atomic<size_type> m_published{0};
+};
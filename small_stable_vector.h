@@ -0,0 +1,184 @@
+#pragma once
+
+#include "stable_vector.h"
+
+// Small-buffer variant for workloads with millions of mostly-tiny containers
+// (adjacency lists): the first InlineCapacity elements live inside the
+// container object itself, so small instances never touch the heap and never
+// pay for a full ChunkSize chunk. Growth beyond that falls back to a regular
+// stable_vector. Inline elements keep their addresses as long as the
+// container itself isn't moved; overflow elements are chunk-stable as usual.
+template <class T, std::size_t InlineCapacity, std::size_t ChunkSize = 1024, class Allocator = std::allocator<T>>
+class small_stable_vector
+{
+public:
+	using value_type = T;
+	using allocator_type = Allocator;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr const std::size_t inline_capacity = InlineCapacity;
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+private:
+	using __self = small_stable_vector<T, InlineCapacity, ChunkSize, Allocator>;
+	using __const_self = const small_stable_vector<T, InlineCapacity, ChunkSize, Allocator>;
+
+	// Tiny containers iterate rarely and briefly; the plain index-based
+	// iterator keeps this class small.
+	template <class Container>
+	struct iterator_base
+	{
+		iterator_base(Container* c = nullptr, size_type i = 0) :
+			m_container(c),
+			m_index(i)
+		{}
+
+		iterator_base& operator+=(size_type i) { m_index += i; return *this; }
+		iterator_base& operator-=(size_type i) { m_index -= i; return *this; }
+		iterator_base& operator++()            { ++m_index; return *this; }
+		iterator_base& operator--()            { --m_index; return *this; }
+
+		difference_type operator-(const iterator_base& it) const { assert(m_container == it.m_container); return static_cast<difference_type>(m_index) - static_cast<difference_type>(it.m_index); }
+
+		bool operator< (const iterator_base& it) const { assert(m_container == it.m_container); return m_index < it.m_index; }
+		bool operator==(const iterator_base& it) const { return m_container == it.m_container && m_index == it.m_index; }
+
+	 protected:
+		Container* m_container;
+		size_type m_index;
+	};
+
+public:
+	struct const_iterator;
+
+	struct iterator :
+		public iterator_base<__self>,
+		public boost::random_access_iterator_helper<iterator, value_type>
+	{
+		using iterator_base<__self>::iterator_base;
+		friend struct const_iterator;
+
+		reference operator*() { return (*this->m_container)[this->m_index]; }
+	};
+
+	struct const_iterator :
+		public iterator_base<__const_self>,
+		public boost::random_access_iterator_helper<const_iterator, const value_type>
+	{
+		using iterator_base<__const_self>::iterator_base;
+
+		const_iterator(const iterator& it) :
+			iterator_base<__const_self>(it.m_container, it.m_index)
+		{
+		}
+
+		const_reference operator*() const { return (*this->m_container)[this->m_index]; }
+
+		bool operator==(const const_iterator& it) const
+		{
+			return iterator_base<__const_self>::operator==(it);
+		}
+
+		friend bool operator==(const iterator& l, const const_iterator& r) { return r == l; }
+	};
+
+	small_stable_vector() = default;
+
+	small_stable_vector(std::initializer_list<T> ilist)
+	{
+		for (const auto& t : ilist)
+		{
+			push_back(t);
+		}
+	}
+
+	iterator begin() noexcept { return {this, 0}; }
+	const_iterator begin() const noexcept { return {this, 0}; }
+	const_iterator cbegin() const noexcept { return begin(); }
+
+	iterator end() noexcept { return {this, size()}; }
+	const_iterator end() const noexcept { return {this, size()}; }
+	const_iterator cend() const noexcept { return end(); }
+
+	size_type size() const noexcept { return m_inline.size() + m_overflow.size(); }
+	size_type capacity() const noexcept { return InlineCapacity + m_overflow.capacity(); }
+
+	bool empty() const noexcept { return m_inline.empty(); }
+
+	bool operator==(const __const_self& c) const { return size() == c.size() && std::equal(cbegin(), cend(), c.cbegin()); }
+	bool operator!=(const __const_self& c) const { return !operator==(c); }
+
+	reference front()             { return m_inline.front(); }
+	const_reference front() const { return m_inline.front(); }
+
+	reference back()             { return m_overflow.empty() ? m_inline.back() : m_overflow.back(); }
+	const_reference back() const { return m_overflow.empty() ? m_inline.back() : m_overflow.back(); }
+
+	void push_back(const T& t) { emplace_back(t); }
+	void push_back(T&& t)      { emplace_back(std::move(t)); }
+
+	template <class... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (m_inline.size() < InlineCapacity)
+		{
+			m_inline.emplace_back(std::forward<Args>(args)...);
+		}
+		else
+		{
+			m_overflow.emplace_back(std::forward<Args>(args)...);
+		}
+	}
+
+	void pop_back()
+	{
+		if (!m_overflow.empty())
+		{
+			m_overflow.pop_back();
+		}
+		else
+		{
+			m_inline.pop_back();
+		}
+	}
+
+	void clear()
+	{
+		m_inline.clear();
+		m_overflow.clear();
+	}
+
+	reference operator[](size_type i)
+	{
+		return i < InlineCapacity ? m_inline[i] : m_overflow[i - InlineCapacity];
+	}
+
+	const_reference operator[](size_type i) const
+	{
+		return const_cast<__self&>(*this)[i];
+	}
+
+	reference at(size_type i)
+	{
+		if (likely_false(i >= size()))
+		{
+			throw std::out_of_range("small_stable_vector::at");
+		}
+
+		return operator[](i);
+	}
+
+	const_reference at(size_type i) const
+	{
+		return const_cast<__self&>(*this).at(i);
+	}
+
+private:
+	boost::container::static_vector<T, InlineCapacity> m_inline;
+	stable_vector<T, ChunkSize, Allocator> m_overflow;
+};
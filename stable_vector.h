@@ -7,18 +7,63 @@
 #include <iterator>
 #include <algorithm>
 #include <numeric>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unordered_map>
 
 #include <boost/operators.hpp>
 #include <boost/container/static_vector.hpp>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #define likely_false(x) __builtin_expect((x), 0)
 #define likely_true(x)  __builtin_expect((x), 1)
 
-template <class T, std::size_t ChunkSize = 1024>
+// Opt-in instrumentation: build with -DSTABLE_VECTOR_STATS to count chunk
+// traffic and access patterns per container, scraped via stats(). In the
+// default configuration the counters and the counting statements compile to
+// exactly nothing.
+#ifdef STABLE_VECTOR_STATS
+#define stable_vector_count(expr) ((void)(expr))
+#else
+#define stable_vector_count(expr) ((void)0)
+#endif
+
+#ifdef STABLE_VECTOR_STATS
+struct stable_vector_stats
+{
+	std::size_t push_backs = 0;        // push_back/emplace_back calls
+	std::size_t chunks_added = 0;      // times a chunk went live (add/prepend)
+	std::size_t chunk_allocations = 0; // chunks that hit the allocator (not recycled)
+	std::size_t peak_chunks = 0;       // high-water mark of live chunks
+	std::size_t index_accesses = 0;    // operator[] calls
+	std::size_t chunk_crossings = 0;   // operator[] calls landing in a different chunk than the last
+};
+#endif
+
+// Page backing hint for compact(): huge asks the kernel (madvise
+// MADV_HUGEPAGE) to back the compacted slab with transparent huge pages, so
+// one 2MB page covers hundreds of chunks on a TLB-bound scan. A no-op off
+// Linux.
+enum class page_hint
+{
+	none,
+	huge
+};
+
+template <class T, std::size_t ChunkSize = 1024, class Allocator = std::allocator<T>>
 class stable_vector
 {
 public:
 	using value_type = T;
+	using allocator_type = Allocator;
 	using reference = value_type&;
 	using const_reference = const value_type&;
 	using pointer = value_type*;
@@ -34,21 +79,128 @@ private:
 
 	static_assert(is_pow2<ChunkSize>::value, "ChunkSize needs to be a power of 2");
 
-	using __self = stable_vector<T, ChunkSize>;
-	using __const_self = const stable_vector<T, ChunkSize>;
+	using __self = stable_vector<T, ChunkSize, Allocator>;
+	using __const_self = const stable_vector<T, ChunkSize, Allocator>;
+
+	using chunk_type = boost::container::static_vector<T, ChunkSize>;
+	using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk_type>;
+	using chunk_alloc_traits = std::allocator_traits<chunk_allocator>;
+
+	// Chunks are released through the allocator they came from; the deleter
+	// carries its own copy so chunks stay self-contained across container
+	// moves and swaps. Chunks commissioned out of a reserve() slab are
+	// non-owning: the deleter destroys the chunk object but the memory
+	// belongs to the slab.
+	struct chunk_deleter
+	{
+		chunk_deleter(const chunk_allocator& alloc = chunk_allocator(), bool owning = true) :
+			m_alloc(alloc),
+			m_owning(owning)
+		{}
+
+		void operator()(chunk_type* chunk)
+		{
+			chunk_alloc_traits::destroy(m_alloc, chunk);
+			if (m_owning)
+			{
+				chunk_alloc_traits::deallocate(m_alloc, chunk, 1);
+			}
+		}
+
+	 private:
+		chunk_allocator m_alloc;
+		bool m_owning;
+	};
+
+	// One reserve() allocation covering several chunk slots; slots are
+	// commissioned into live chunks lazily by add_chunk().
+	struct slab
+	{
+		chunk_type* data;
+		size_type count;
+		size_type commissioned;
+	};
+
+	using chunk_ptr = std::unique_ptr<chunk_type, chunk_deleter>;
+	using storage_type = std::vector<chunk_ptr>;
+
+	// A segment is the contiguous span of one chunk's elements. Handing spans
+	// out directly lets callers run flat-array (autovectorized or explicit
+	// SIMD) kernels that the element-wise iterators can't express.
+	template <class Pointer>
+	struct basic_segment
+	{
+		Pointer data;
+		size_type size;
+	};
+
+	template <class Segment>
+	struct segment_iterator_base
+	{
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Segment;
+		using reference = Segment;
+		using pointer = void;
+		using difference_type = std::ptrdiff_t;
+
+		explicit segment_iterator_base(const chunk_ptr* chunk = nullptr, size_type skip = 0) :
+			m_chunk(chunk),
+			m_skip(skip)
+		{}
+
+		// m_skip hides the first chunk's dead pop_front() prefix; it is only
+		// ever non-zero at the front position.
+		Segment operator*() const { return {(*m_chunk)->data() + m_skip, (*m_chunk)->size() - m_skip}; }
+
+		segment_iterator_base& operator++()   { ++m_chunk; m_skip = 0; return *this; }
+		segment_iterator_base operator++(int) { auto it = *this; operator++(); return it; }
 
+		bool operator==(const segment_iterator_base& it) const { return m_chunk == it.m_chunk; }
+		bool operator!=(const segment_iterator_base& it) const { return !operator==(it); }
+
+	 private:
+		const chunk_ptr* m_chunk;
+		size_type m_skip;
+	};
+
+	// Iterators carry a cached pointer into the current chunk so that the hot
+	// path of operator++/operator* is a pointer bump plus an end-of-chunk
+	// compare; the div/mod through operator[] only happens on chunk crossings
+	// and after arbitrary jumps (+=, -=). The cache may go stale when the
+	// container grows (a partially filled chunk gains elements), which is safe:
+	// a stale end-of-chunk sentinel only causes an early recache, and since
+	// chunks never move the cached pointer itself always stays valid.
 	template <class Container>
 	struct iterator_base
 	{
+		using element_pointer = typename std::conditional<std::is_const<Container>::value, const_pointer, pointer>::type;
+
 		iterator_base(Container* c = nullptr, size_type i = 0) :
 			m_container(c),
 			m_index(i)
-		{}
+		{
+			recache();
+		}
+
+		iterator_base& operator+=(size_type i) { m_index += i; recache(); return *this; }
+		iterator_base& operator-=(size_type i) { m_index -= i; recache(); return *this; }
 
-		iterator_base& operator+=(size_type i) { m_index += i; return *this; }
-		iterator_base& operator-=(size_type i) { m_index -= i; return *this; }
-		iterator_base& operator++()            { ++m_index; return *this; }
-		iterator_base& operator--()            { --m_index; return *this; }
+		iterator_base& operator++()
+		{
+			++m_index;
+			if (likely_false(!m_ptr || ++m_ptr == m_chunk_end))
+			{
+				recache();
+			}
+			return *this;
+		}
+
+		iterator_base& operator--()
+		{
+			--m_index;
+			recache();
+			return *this;
+		}
 
 		difference_type operator-(const iterator_base& it) { assert(m_container == it.m_container); return m_index - it.m_index; }
 
@@ -56,8 +208,38 @@ private:
 		bool operator==(const iterator_base& it) const { return m_container == it.m_container && m_index == it.m_index; }
 
 	 protected:
+		element_pointer element() const
+		{
+			if (likely_false(!m_ptr))
+			{
+				recache();
+			}
+			return m_ptr;
+		}
+
 		Container* m_container;
 		size_type m_index;
+
+	 private:
+		void recache() const
+		{
+			if (likely_true(m_container && m_index < m_container->size()))
+			{
+				const size_type p = m_index + m_container->m_offset;
+				const size_type chunk_begin = p / ChunkSize * ChunkSize;
+				const auto data = m_container->m_table[p / ChunkSize];
+				m_ptr = data + p % ChunkSize;
+				m_chunk_end = data + std::min(ChunkSize, m_container->m_offset + m_container->size() - chunk_begin);
+			}
+			else
+			{
+				m_ptr = nullptr;
+				m_chunk_end = nullptr;
+			}
+		}
+
+		mutable element_pointer m_ptr;
+		mutable element_pointer m_chunk_end;
 	};
 
 public:
@@ -70,7 +252,7 @@ public:
 		using iterator_base<__self>::iterator_base;
 		friend struct const_iterator;
 
-		reference operator*() { return (*this->m_container)[this->m_index]; }
+		reference operator*() const { return *this->element(); }
 	};
 
 	struct const_iterator :
@@ -84,7 +266,7 @@ public:
 		{
 		}
 
-		const_reference operator*() const { return (*this->m_container)[this->m_index]; }
+		const_reference operator*() const { return *this->element(); }
 
 		bool operator==(const const_iterator& it) const
 		{
@@ -95,19 +277,33 @@ public:
 	};
 
 	stable_vector() = default;
-	explicit stable_vector(size_type count, const T& value);
-	explicit stable_vector(size_type count);
+	explicit stable_vector(const Allocator& alloc);
+	explicit stable_vector(size_type count, const T& value, const Allocator& alloc = Allocator());
+	explicit stable_vector(size_type count, const Allocator& alloc = Allocator());
 
 	template <class InputIt,
 			  class = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>>
-	stable_vector(InputIt first, InputIt last);
+	stable_vector(InputIt first, InputIt last, const Allocator& alloc = Allocator());
 
-	stable_vector(std::initializer_list<T>);
+	stable_vector(std::initializer_list<T>, const Allocator& alloc = Allocator());
+
+	// Repacking constructors between instantiations with different chunk
+	// sizes; see the append() overloads below.
+	template <std::size_t OtherChunkSize, class OtherAllocator>
+	explicit stable_vector(const stable_vector<T, OtherChunkSize, OtherAllocator>& other, const Allocator& alloc = Allocator());
+
+	template <std::size_t OtherChunkSize, class OtherAllocator>
+	explicit stable_vector(stable_vector<T, OtherChunkSize, OtherAllocator>&& other, const Allocator& alloc = Allocator());
 
 	stable_vector(const stable_vector& other);
 	stable_vector(stable_vector&& other) noexcept;
 
-	stable_vector& operator=(stable_vector v);
+	~stable_vector();
+
+	stable_vector& operator=(const stable_vector& v);
+	stable_vector& operator=(stable_vector&& v) noexcept;
+
+	allocator_type get_allocator() const noexcept { return m_alloc; }
 
 	iterator begin() noexcept { return {this, 0}; }
 	const_iterator begin() const noexcept { return {this, 0}; }
@@ -117,34 +313,324 @@ public:
 	const_iterator end() const noexcept { return {this, size()}; }
 	const_iterator cend() const noexcept { return end(); }
 
-	size_type size() const noexcept { return empty() ? 0 : (m_chunks.size() - 1) * ChunkSize + m_chunks.back()->size(); }
+	using segment = basic_segment<pointer>;
+	using const_segment = basic_segment<const_pointer>;
+
+	using segment_iterator = segment_iterator_base<segment>;
+	using const_segment_iterator = segment_iterator_base<const_segment>;
+
+	segment_iterator segment_begin() noexcept { return segment_iterator{m_chunks.data(), m_offset}; }
+	const_segment_iterator segment_begin() const noexcept { return const_segment_iterator{m_chunks.data(), m_offset}; }
+
+	segment_iterator segment_end() noexcept { return segment_iterator{m_chunks.data() + m_chunks.size()}; }
+	const_segment_iterator segment_end() const noexcept { return const_segment_iterator{m_chunks.data() + m_chunks.size()}; }
+
+	// Invokes f(data, size) once per chunk; each span is contiguous. The
+	// first span starts past any dead pop_front() prefix.
+	template <class F>
+	void for_each_chunk(F&& f)
+	{
+		size_type skip = m_offset;
+		for (const auto& chunk : m_chunks)
+		{
+			f(chunk->data() + skip, chunk->size() - skip);
+			skip = 0;
+		}
+	}
+
+	template <class F>
+	void for_each_chunk(F&& f) const
+	{
+		size_type skip = m_offset;
+		for (const auto& chunk : m_chunks)
+		{
+			f(static_cast<const_pointer>(chunk->data() + skip), chunk->size() - skip);
+			skip = 0;
+		}
+	}
+
+	// Read-only view of the contents at a point in time, for background
+	// consumers of append-only containers. Full chunks are shared with the
+	// source by pointer and only the partial tail chunk is deep-copied, so
+	// taking a snapshot is O(chunks) with at most one chunk of memory
+	// overhead. The view remains valid while the source is alive and only
+	// grows; erase, clear, shrink_to_fit or destruction of the source
+	// invalidate it.
+	class snapshot_type
+	{
+	public:
+		explicit snapshot_type(const __self& v) :
+			m_table(v.m_table.begin(), v.m_table.end()),
+			m_size(v.m_size),
+			m_offset(v.m_offset)
+		{
+			const size_type tail = (m_offset + m_size) % ChunkSize;
+			if (tail != 0)
+			{
+				const const_pointer data = m_table.back();
+				m_tail.assign(data, data + tail);
+				m_table.back() = m_tail.data();
+			}
+		}
+
+		// The chunk table may point into m_tail, so moving is fine (the tail
+		// buffer travels along) but a memberwise copy would dangle.
+		snapshot_type(const snapshot_type&) = delete;
+		snapshot_type& operator=(const snapshot_type&) = delete;
+		snapshot_type(snapshot_type&&) = default;
+		snapshot_type& operator=(snapshot_type&&) = default;
+
+		size_type size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+
+		const_reference front() const { return operator[](0); }
+		const_reference back() const { return operator[](m_size - 1); }
+
+		const_reference operator[](size_type i) const
+		{
+			const size_type p = i + m_offset;
+			return m_table[p / ChunkSize][p % ChunkSize];
+		}
+
+		const_reference at(size_type i) const
+		{
+			if (likely_false(i >= m_size))
+			{
+				throw std::out_of_range("stable_vector::snapshot_type::at");
+			}
+
+			return operator[](i);
+		}
+
+		template <class F>
+		void for_each_chunk(F&& f) const
+		{
+			size_type skip = m_offset;
+			const size_type total = m_offset + m_size;
+			for (size_type c = 0; c * ChunkSize < total; ++c)
+			{
+				f(m_table[c] + skip, std::min(ChunkSize, total - c * ChunkSize) - skip);
+				skip = 0;
+			}
+		}
+
+	private:
+		std::vector<const_pointer> m_table;
+		std::vector<value_type> m_tail;
+		size_type m_size;
+		size_type m_offset;
+	};
+
+	snapshot_type snapshot() const { return snapshot_type(*this); }
+
+	// Bulk-append cursor for hot ingestion loops of known burst size.
+	// writer(n) reserves room for n more elements and materializes chunk
+	// slots a chunk at a time, so push_back() is a raw pointer store plus one
+	// predictable branch: the per-element last_chunk() check and the
+	// m_chunks.back() double-deref are hoisted to once per chunk. Push at
+	// most n elements (debug-asserted); the destructor gives back whatever
+	// was reserved but never written. Trivially copyable element types only,
+	// since slots are materialized before being assigned.
+	class writer_type
+	{
+	public:
+		writer_type(__self& v, size_type count) :
+			m_container(&v),
+			m_remaining(count)
+		{
+			static_assert(std::is_trivially_copyable<T>::value,
+						  "stable_vector::writer requires a trivially copyable element type");
+
+			v.reserve(v.size() + count);
+			next_chunk();
+		}
+
+		writer_type(writer_type&& other) noexcept :
+			m_container(other.m_container),
+			m_cursor(other.m_cursor),
+			m_chunk_end(other.m_chunk_end),
+			m_remaining(other.m_remaining)
+		{
+			other.m_container = nullptr;
+			other.m_cursor = nullptr;
+			other.m_chunk_end = nullptr;
+		}
+
+		writer_type(const writer_type&) = delete;
+		writer_type& operator=(const writer_type&) = delete;
+		writer_type& operator=(writer_type&&) = delete;
+
+		~writer_type()
+		{
+			if (m_container && m_cursor != m_chunk_end)
+			{
+				// Give back the slots of the current chunk that were
+				// materialized but never written.
+				m_container->shrink_to(m_container->m_size - static_cast<size_type>(m_chunk_end - m_cursor));
+			}
+		}
+
+		void push_back(const T& t)
+		{
+			assert(m_cursor != m_chunk_end);
+
+			*m_cursor++ = t;
+
+			if (likely_false(m_cursor == m_chunk_end && m_remaining != 0))
+			{
+				next_chunk();
+			}
+		}
+
+	private:
+		void next_chunk()
+		{
+			if (m_remaining == 0)
+			{
+				m_cursor = nullptr;
+				m_chunk_end = nullptr;
+				return;
+			}
+
+			chunk_type& chunk = m_container->last_chunk();
+			const size_type take = std::min(ChunkSize - chunk.size(), m_remaining);
+			chunk.resize(chunk.size() + take, boost::container::default_init);
+			m_container->m_size += take;
+			m_remaining -= take;
+			m_chunk_end = chunk.data() + chunk.size();
+			m_cursor = m_chunk_end - take;
+		}
+
+		__self* m_container;
+		pointer m_cursor = nullptr;
+		pointer m_chunk_end = nullptr;
+		size_type m_remaining;
+	};
+
+	writer_type writer(size_type count) { return writer_type(*this, count); }
+
+	size_type size() const noexcept { return m_size; }
 	size_type max_size() const noexcept { return std::numeric_limits<size_type>::max(); }
-	size_type capacity() const noexcept { return m_chunks.size() * ChunkSize; }
+	size_type capacity() const noexcept { return (m_chunks.size() + m_spare.size() + m_uncommissioned.size()) * ChunkSize; }
 
-	bool empty() const noexcept { return m_chunks.size() == 0; }
+	bool empty() const noexcept { return m_size == 0; }
 
-	void reserve(size_type new_capacity);
-	void shrink_to_fit() noexcept {}
+#ifdef STABLE_VECTOR_STATS
+	const stable_vector_stats& stats() const noexcept { return m_stats; }
+#endif
 
-	bool operator==(const __self& c) const { return size() == c.size() && std::equal(cbegin(), cend(), c.cbegin()); }
+	void reserve(size_type new_capacity);
+	void shrink_to_fit() noexcept;
+
+	// Migrates all elements into chunks commissioned from one fresh
+	// contiguous slab, so full scans walk consecutive pages instead of
+	// thousands of scattered per-chunk allocations. Invalidates every
+	// pointer, reference and iterator — that is the deal, which is why this
+	// is a separate explicit call and never happens behind an append. For
+	// growth that is contiguous from the start, reserve() ahead of time: all
+	// chunks then commission out of one slab and compact() is a no-op worth
+	// of work avoided.
+	void compact(page_hint hint = page_hint::none);
+
+	void resize(size_type count);
+	void resize(size_type count, const T& value);
+
+	// resize() without the value-initialization pass, for trivially default
+	// constructible types: bulk readers (deserialize()) materialize elements
+	// and then overwrite them wholesale.
+	void resize_default_init(size_type count);
+
+	void pop_back() noexcept;
+	void clear() noexcept;
+
+	// Comparisons walk the chunk tables directly: chunk boundaries line up
+	// (every chunk but the last is full), so both sides compare as matched
+	// contiguous spans instead of paying the two-level addressing of the
+	// iterators per element. Byte-comparable element types go through one
+	// memcmp per chunk.
+	bool operator==(const __self& c) const;
 	bool operator!=(const __self& c) const { return !operator==(c); }
 
-	void swap(__self& v) { std::swap(m_chunks, v.m_chunks); }
+	bool operator< (const __self& c) const;
+	bool operator> (const __self& c) const { return c < *this; }
+	bool operator<=(const __self& c) const { return !(c < *this); }
+	bool operator>=(const __self& c) const { return !(*this < c); }
+
+	void swap(__self& v) noexcept
+	{
+		std::swap(m_chunks, v.m_chunks);
+		std::swap(m_spare, v.m_spare);
+		std::swap(m_uncommissioned, v.m_uncommissioned);
+		std::swap(m_slabs, v.m_slabs);
+		std::swap(m_table, v.m_table);
+		std::swap(m_size, v.m_size);
+		std::swap(m_offset, v.m_offset);
+		std::swap(m_last, v.m_last);
+		std::swap(m_alloc, v.m_alloc);
+	}
 
 	friend void swap(__self& l, __self& r) { l.swap(r); }
 
-	reference front()             { return m_chunks.front()->front(); }
-	const_reference front() const { return front(); }
+	reference front()             { return (*m_chunks.front())[m_offset]; }
+	const_reference front() const { return (*m_chunks.front())[m_offset]; }
 
 	reference back()             { return m_chunks.back()->back(); }
 	const_reference back() const { return back(); }
 
+	void append(size_type count, const T& value);
+
+	template <class InputIt,
+			  class = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>>
+	void append(InputIt first, InputIt last);
+
+	// Repacking between instantiations with different chunk sizes (staging
+	// buffer to long-term store): both chunk structures are walked directly
+	// and every span intersection transfers as one contiguous bulk insert,
+	// which collapses to memcpy/memmove for trivially copyable types —
+	// never the per-element two-level iterator path. The && overload moves
+	// the elements and leaves other empty.
+	template <std::size_t OtherChunkSize, class OtherAllocator>
+	void append(const stable_vector<T, OtherChunkSize, OtherAllocator>& other);
+
+	template <std::size_t OtherChunkSize, class OtherAllocator>
+	void append(stable_vector<T, OtherChunkSize, OtherAllocator>&& other);
+
+	void assign(size_type count, const T& value);
+
+	template <class InputIt,
+			  class = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>>
+	void assign(InputIt first, InputIt last);
+
+	void assign(std::initializer_list<T> ilist);
+
+	// Appends another container's elements by re-pointing whole chunks;
+	// leaves other empty. Requires equal allocators.
+	void splice(__self&& other);
+
+	// Strong guarantee: if constructing the element throws, the container is
+	// untouched — a chunk that went live just for that element is retired
+	// again before the exception escapes.
 	void push_back(const T& t);
 	void push_back(T&& t);
 
+	// Front operations for sliding-window use. pop_front() is amortized O(1):
+	// it advances a start offset into the first chunk and recycles the chunk
+	// once drained — popped elements are destroyed when their chunk drains,
+	// not individually. push_front() fills the drained slots back in; when
+	// none are left it materializes a fresh value-initialized front chunk.
+	void push_front(T value);
+	void pop_front() noexcept;
+
 	template <class... Args>
 	void emplace_back(Args&&... args);
 
+	iterator insert(const_iterator pos, T value);
+	iterator erase(const_iterator pos);
+
+	// O(1) erase that fills the hole with the last element: every element
+	// except the erased one and the (relocated) back keeps its address.
+	iterator unordered_erase(const_iterator pos);
+
 	reference operator[](size_type i);
 
 	const_reference operator[](size_type i) const;
@@ -153,14 +639,94 @@ public:
 
 	const_reference at(size_type i) const;
 
+	// Hints the cache to pull in element i ahead of an access. The chunk
+	// table itself is small and usually resident, so the dependent load it
+	// takes to form the element address is cheap next to the element miss
+	// being hidden.
+	void prefetch(size_type i) const
+	{
+		const size_type p = i + m_offset;
+		__builtin_prefetch(m_table[p / ChunkSize] + p % ChunkSize);
+	}
+
+	// Batched random access for miss-bound index streams (hash-join probes,
+	// permutation gathers): a plain operator[] loop serializes a chunk-table
+	// load and an element load per index, so each lookup eats a full miss
+	// latency. gather() works the indices in small batches — prefetch all the
+	// table slots, then all the element lines, then read — so the misses of a
+	// whole batch overlap instead of queuing behind each other.
+	template <class OutputIt>
+	OutputIt gather(const size_type* indices, size_type count, OutputIt out) const;
+
 private:
-	using chunk_type = boost::container::static_vector<T, ChunkSize>;
-	using storage_type = std::vector<std::unique_ptr<chunk_type>>;
+	template <class... Args>
+	chunk_ptr new_chunk(Args&&... args);
 
+	chunk_ptr acquire_chunk();
 	void add_chunk();
+	void prepend_chunk();
 	chunk_type& last_chunk();
+	void retire_last_chunk();
+
+	template <class It>
+	void append_span(It first, size_type count);
+
+	// Strong-guarantee cleanup after a throwing element construction: a chunk
+	// that went live just for the failed element is retired again. Live
+	// chunks are never empty otherwise, so emptiness identifies them.
+	void rollback_chunk(chunk_type& chunk) noexcept
+	{
+		if (chunk.empty())
+		{
+			retire_last_chunk();
+		}
+	}
 
+	void shrink_to(size_type count);
+
+	// memcmp compares equal exactly when the elements do: integers, enums
+	// and pointers, but not padded structs or floats (-0.0, NaN).
+	using memcmp_comparable = std::integral_constant<bool,
+		std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>;
+
+	static bool span_equal(const_pointer a, const_pointer b, size_type n, std::true_type) { return std::memcmp(a, b, n * sizeof(T)) == 0; }
+	static bool span_equal(const_pointer a, const_pointer b, size_type n, std::false_type) { return std::equal(a, a + n, b); }
+
+	template <class ForwardIt>
+	void append_dispatch(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+	template <class InputIt>
+	void append_dispatch(InputIt first, InputIt last, std::input_iterator_tag);
+
+	// Chunks the sequence has outgrown park in m_spare and are recycled by
+	// add_chunk(), so clear-and-refill cycles don't touch the allocator.
+	// reserve() grabs whole slabs instead and lists the raw slots in
+	// m_uncommissioned; add_chunk() prefers spares, then slab slots, then a
+	// fresh allocation. Only m_chunks holds live elements.
+	//
+	// m_table mirrors m_chunks as a flat array of raw element pointers and
+	// m_size tracks the element count centrally, so random access is two
+	// dependent loads (table entry, then element) with no unique_ptr chase,
+	// no static_vector offset and no per-chunk size read. m_last caches the
+	// chunk push_back appends into, sparing the m_chunks.back() double-deref.
 	storage_type m_chunks;
+	storage_type m_spare;
+	std::vector<chunk_type*> m_uncommissioned;
+	std::vector<slab> m_slabs;
+	std::vector<pointer> m_table;
+#ifdef STABLE_VECTOR_STATS
+	// mutable so const random access can record its pattern.
+	mutable stable_vector_stats m_stats;
+	mutable size_type m_stats_last_chunk = std::numeric_limits<size_type>::max();
+#endif
+
+	size_type m_size = 0;
+	// Dead-but-alive prefix of the first chunk left behind by pop_front();
+	// all index math maps logical index i to physical slot i + m_offset, so
+	// containers that never touch the front pay one add, not a branch.
+	size_type m_offset = 0;
+	chunk_type* m_last = nullptr;
+	allocator_type m_alloc;
 };
 
 
@@ -169,128 +735,814 @@ private:
 
 
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>::stable_vector(size_type count, const T& value)
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(const Allocator& alloc) :
+	m_alloc(alloc)
+{
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(size_type count, const T& value, const Allocator& alloc) :
+	m_alloc(alloc)
+{
+	append(count, value);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(size_type count, const Allocator& alloc) :
+	m_alloc(alloc)
+{
+	resize(count);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class InputIt, class>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(InputIt first, InputIt last, const Allocator& alloc) :
+	m_alloc(alloc)
+{
+	append(first, last);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(const stable_vector& other) :
+	m_alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_alloc))
 {
-	for (size_type i = 0; i < count; ++i)
+	// A dead pop_front() prefix isn't worth copying; rebuild compactly.
+	if (likely_false(other.m_offset != 0))
+	{
+		append(other.begin(), other.end());
+		return;
+	}
+
+	for (const auto& chunk : other.m_chunks)
 	{
-		push_back(value);
+		m_chunks.emplace_back(new_chunk(*chunk));
+		m_table.push_back(m_chunks.back()->data());
 	}
+
+	m_size = other.m_size;
+	m_last = m_chunks.empty() ? nullptr : m_chunks.back().get();
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(stable_vector&& other) noexcept :
+	m_chunks(std::move(other.m_chunks)),
+	m_spare(std::move(other.m_spare)),
+	m_uncommissioned(std::move(other.m_uncommissioned)),
+	m_slabs(std::move(other.m_slabs)),
+	m_table(std::move(other.m_table)),
+	m_size(other.m_size),
+	m_offset(other.m_offset),
+	m_last(other.m_last),
+	m_alloc(std::move(other.m_alloc))
+{
+	other.m_size = 0;
+	other.m_offset = 0;
+	other.m_last = nullptr;
 }
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>::stable_vector(size_type count)
+// Chunk objects (and their elements) go first, then the slab memory they may
+// live in.
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::~stable_vector()
 {
-	for (size_type i = 0; i < count; ++i)
+	m_chunks.clear();
+	m_spare.clear();
+
+	chunk_allocator alloc(m_alloc);
+	for (const slab& s : m_slabs)
 	{
-		emplace_back();
+		chunk_alloc_traits::deallocate(alloc, s.data, s.count);
 	}
 }
 
-template <class T, std::size_t ChunkSize>
-template <class InputIt, class>
-stable_vector<T, ChunkSize>::stable_vector(InputIt first, InputIt last)
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(std::initializer_list<T> ilist, const Allocator& alloc) :
+	m_alloc(alloc)
 {
-	for (; first != last; ++first)
+	append(ilist.begin(), ilist.end());
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <std::size_t OtherChunkSize, class OtherAllocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(const stable_vector<T, OtherChunkSize, OtherAllocator>& other, const Allocator& alloc) :
+	m_alloc(alloc)
+{
+	append(other);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <std::size_t OtherChunkSize, class OtherAllocator>
+stable_vector<T, ChunkSize, Allocator>::stable_vector(stable_vector<T, OtherChunkSize, OtherAllocator>&& other, const Allocator& alloc) :
+	m_alloc(alloc)
+{
+	append(std::move(other));
+}
+
+// Copy assignment is copy-and-swap: a throwing element copy leaves *this
+// untouched (strong guarantee). Move assignment trades contents and never
+// throws.
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>& stable_vector<T, ChunkSize, Allocator>::operator=(const stable_vector& v)
+{
+	stable_vector copy(v);
+	swap(copy);
+	return *this;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+stable_vector<T, ChunkSize, Allocator>& stable_vector<T, ChunkSize, Allocator>::operator=(stable_vector&& v) noexcept
+{
+	// Destroy the old elements now rather than when v goes out of scope.
+	clear();
+	swap(v);
+	return *this;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class... Args>
+typename stable_vector<T, ChunkSize, Allocator>::chunk_ptr
+stable_vector<T, ChunkSize, Allocator>::new_chunk(Args&&... args)
+{
+	stable_vector_count(++m_stats.chunk_allocations);
+
+	chunk_allocator alloc(m_alloc);
+	chunk_type* chunk = chunk_alloc_traits::allocate(alloc, 1);
+
+	try
 	{
-		push_back(*first);
+		chunk_alloc_traits::construct(alloc, chunk, std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		chunk_alloc_traits::deallocate(alloc, chunk, 1);
+		throw;
 	}
+
+	return chunk_ptr(chunk, chunk_deleter(alloc));
 }
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>::stable_vector(const stable_vector& other)
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::chunk_ptr
+stable_vector<T, ChunkSize, Allocator>::acquire_chunk()
 {
-	for (const auto& chunk : other.m_chunks)
+	if (!m_spare.empty())
+	{
+		chunk_ptr chunk = std::move(m_spare.back());
+		m_spare.pop_back();
+		return chunk;
+	}
+
+	if (!m_uncommissioned.empty())
 	{
-		m_chunks.emplace_back(std::make_unique<chunk_type>(*chunk));
+		chunk_type* slot = m_uncommissioned.back();
+		chunk_allocator alloc(m_alloc);
+		chunk_alloc_traits::construct(alloc, slot);
+		m_uncommissioned.pop_back();
+
+		for (slab& s : m_slabs)
+		{
+			if (slot >= s.data && slot < s.data + s.count)
+			{
+				++s.commissioned;
+				break;
+			}
+		}
+
+		return chunk_ptr(slot, chunk_deleter(alloc, false));
 	}
+
+	return new_chunk();
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::add_chunk()
+{
+	m_chunks.emplace_back(acquire_chunk());
+	m_table.push_back(m_chunks.back()->data());
+	m_last = m_chunks.back().get();
+
+	stable_vector_count(++m_stats.chunks_added);
+	stable_vector_count(m_stats.peak_chunks = std::max(m_stats.peak_chunks, m_chunks.size()));
+}
+
+// A fresh front chunk is materialized full (value-initialized) so the dead
+// slots above m_offset stay assignable; push_front() then claims them one by
+// one. O(chunks) for the two front inserts, O(ChunkSize) construction —
+// both amortized over the ChunkSize front pushes the chunk absorbs.
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::prepend_chunk()
+{
+	chunk_ptr chunk = acquire_chunk();
+	chunk->resize(ChunkSize);
+	m_table.insert(m_table.begin(), chunk->data());
+	m_chunks.insert(m_chunks.begin(), std::move(chunk));
+	m_offset = ChunkSize;
+
+	stable_vector_count(++m_stats.chunks_added);
+	stable_vector_count(m_stats.peak_chunks = std::max(m_stats.peak_chunks, m_chunks.size()));
 }
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>::stable_vector(stable_vector&& other) noexcept :
-	m_chunks(std::move(other.m_chunks))
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::retire_last_chunk()
 {
+	m_spare.emplace_back(std::move(m_chunks.back()));
+	m_chunks.pop_back();
+	m_table.pop_back();
+	m_last = m_chunks.empty() ? nullptr : m_chunks.back().get();
 }
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>::stable_vector(std::initializer_list<T> ilist)
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::chunk_type& stable_vector<T, ChunkSize, Allocator>::last_chunk()
 {
-	for (const auto& t : ilist)
+	if (likely_false(!m_last || m_last->size() == ChunkSize))
 	{
-		push_back(t);
+		add_chunk();
 	}
+
+	return *m_last;
 }
 
-template <class T, std::size_t ChunkSize>
-stable_vector<T, ChunkSize>& stable_vector<T, ChunkSize>::operator=(stable_vector v)
+// One allocation covers all the missing capacity; no static_vector objects
+// are constructed until add_chunk() commissions a slot, so reserving 100M
+// elements is a single large allocation plus a pointer list.
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::reserve(size_type new_capacity)
 {
-	swap(v);
-	return *this;
+	if (new_capacity <= capacity())
+	{
+		return;
+	}
+
+	const size_type chunks_needed = (new_capacity - capacity() + ChunkSize - 1) / ChunkSize;
+
+	chunk_allocator alloc(m_alloc);
+	chunk_type* raw = chunk_alloc_traits::allocate(alloc, chunks_needed);
+	m_slabs.push_back({raw, chunks_needed, 0});
+
+	for (size_type i = 0; i < chunks_needed; ++i)
+	{
+		m_uncommissioned.push_back(raw + i);
+	}
 }
 
-template <class T, std::size_t ChunkSize>
-void stable_vector<T, ChunkSize>::add_chunk()
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::compact(page_hint hint)
 {
-	m_chunks.emplace_back(std::make_unique<chunk_type>());
+	__self packed(m_alloc);
+	packed.reserve(size());
+
+	// Advise before the elements move in, so pages fault in huge from the
+	// start instead of waiting for khugepaged to collapse them.
+	switch (hint)
+	{
+	case page_hint::none:
+		break;
+	case page_hint::huge:
+#ifdef __linux__
+		for (const slab& s : packed.m_slabs)
+		{
+			const auto addr = reinterpret_cast<std::uintptr_t>(s.data);
+			const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+			const std::uintptr_t first = (addr + page - 1) / page * page;
+			const std::uintptr_t last = (addr + s.count * sizeof(chunk_type)) / page * page;
+			if (last > first)
+			{
+				::madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE);
+			}
+		}
+#endif
+		break;
+	}
+
+	packed.append(std::make_move_iterator(begin()), std::make_move_iterator(end()));
+	swap(packed);
 }
 
-template <class T, std::size_t ChunkSize>
-typename stable_vector<T, ChunkSize>::chunk_type& stable_vector<T, ChunkSize>::last_chunk()
+// Releases spare chunks and any slab no chunk was ever commissioned from.
+// Slab memory with commissioned chunks stays until destruction, since live
+// chunks may point into it.
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::shrink_to_fit() noexcept
 {
-	if (likely_false(m_chunks.empty() || m_chunks.back()->size() == ChunkSize))
+	m_spare.clear();
+
+	chunk_allocator alloc(m_alloc);
+	for (auto it = m_slabs.begin(); it != m_slabs.end();)
 	{
-		add_chunk();
+		if (it->commissioned != 0)
+		{
+			++it;
+			continue;
+		}
+
+		const chunk_type* const first = it->data;
+		const chunk_type* const last = it->data + it->count;
+		m_uncommissioned.erase(
+			std::remove_if(m_uncommissioned.begin(), m_uncommissioned.end(),
+						   [first, last](const chunk_type* slot) { return slot >= first && slot < last; }),
+			m_uncommissioned.end());
+
+		chunk_alloc_traits::deallocate(alloc, it->data, it->count);
+		it = m_slabs.erase(it);
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::resize(size_type count)
+{
+	if (count <= size())
+	{
+		shrink_to(count);
+		return;
 	}
 
-	return *m_chunks.back();
+	size_type remaining = count - size();
+	while (remaining > 0)
+	{
+		chunk_type& chunk = last_chunk();
+		const size_type n = std::min(remaining, ChunkSize - chunk.size());
+		chunk.resize(chunk.size() + n);
+		remaining -= n;
+		m_size += n;
+	}
 }
 
-template <class T, std::size_t ChunkSize>
-void stable_vector<T, ChunkSize>::reserve(size_type new_capacity)
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::resize_default_init(size_type count)
 {
-	const std::size_t initial_capacity = capacity();
-	for (difference_type i = new_capacity - initial_capacity; i > 0; i -= ChunkSize)
+	static_assert(std::is_trivially_default_constructible<T>::value,
+				  "resize_default_init requires a trivially default constructible element type");
+
+	if (count <= size())
 	{
-		add_chunk();
+		shrink_to(count);
+		return;
+	}
+
+	size_type remaining = count - size();
+	while (remaining > 0)
+	{
+		chunk_type& chunk = last_chunk();
+		const size_type n = std::min(remaining, ChunkSize - chunk.size());
+		chunk.resize(chunk.size() + n, boost::container::default_init);
+		remaining -= n;
+		m_size += n;
 	}
 }
 
-template <class T, std::size_t ChunkSize>
-void stable_vector<T, ChunkSize>::push_back(const T& t)
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::resize(size_type count, const T& value)
 {
-	last_chunk().push_back(t);
+	if (count <= size())
+	{
+		shrink_to(count);
+		return;
+	}
+
+	append(count - size(), value);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::pop_back() noexcept
+{
+	chunk_type& chunk = *m_chunks.back();
+	chunk.pop_back();
+	--m_size;
+
+	// The last chunk is drained once only a dead front prefix (when it is
+	// also the first chunk) remains.
+	if (chunk.size() == (m_chunks.size() == 1 ? m_offset : 0))
+	{
+		chunk.clear();
+		retire_last_chunk();
+		if (m_chunks.empty())
+		{
+			m_offset = 0;
+		}
+	}
 }
 
-template <class T, std::size_t ChunkSize>
-void stable_vector<T, ChunkSize>::push_back(T&& t)
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::clear() noexcept
 {
-	last_chunk().push_back(std::move(t));
+	for (auto& chunk : m_chunks)
+	{
+		chunk->clear();
+		m_spare.emplace_back(std::move(chunk));
+	}
+
+	m_chunks.clear();
+	m_table.clear();
+	m_size = 0;
+	m_offset = 0;
+	m_last = nullptr;
 }
 
-template <class T, std::size_t ChunkSize>
+// Destroys elements back to front, chunk by chunk; only trailing chunks can
+// empty out since every chunk but the last is full.
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::shrink_to(size_type count)
+{
+	size_type current = size();
+	while (current > count)
+	{
+		chunk_type& chunk = *m_chunks.back();
+		const size_type floor = m_chunks.size() == 1 ? m_offset : 0;
+		const size_type excess = std::min(current - count, chunk.size() - floor);
+		chunk.resize(chunk.size() - excess);
+		current -= excess;
+		m_size -= excess;
+
+		if (chunk.size() == floor)
+		{
+			chunk.clear();
+			retire_last_chunk();
+			if (m_chunks.empty())
+			{
+				m_offset = 0;
+			}
+		}
+	}
+}
+
+// Bulk filling goes chunk by chunk: one last_chunk() branch per span instead
+// of per element, and chunk_type::insert copies each span in one go (memmove
+// for trivially copyable T).
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::append(size_type count, const T& value)
+{
+	while (count > 0)
+	{
+		chunk_type& chunk = last_chunk();
+		const size_type n = std::min(count, ChunkSize - chunk.size());
+		chunk.insert(chunk.end(), n, value);
+		count -= n;
+		m_size += n;
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class InputIt, class>
+void stable_vector<T, ChunkSize, Allocator>::append(InputIt first, InputIt last)
+{
+	append_dispatch(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class ForwardIt>
+void stable_vector<T, ChunkSize, Allocator>::append_dispatch(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+{
+	size_type remaining = static_cast<size_type>(std::distance(first, last));
+	while (remaining > 0)
+	{
+		chunk_type& chunk = last_chunk();
+		const size_type n = std::min(remaining, ChunkSize - chunk.size());
+		const ForwardIt next = std::next(first, static_cast<difference_type>(n));
+		chunk.insert(chunk.end(), first, next);
+		first = next;
+		remaining -= n;
+		m_size += n;
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class It>
+void stable_vector<T, ChunkSize, Allocator>::append_span(It first, size_type count)
+{
+	while (count > 0)
+	{
+		chunk_type& chunk = last_chunk();
+		const size_type n = std::min(count, ChunkSize - chunk.size());
+		chunk.insert(chunk.end(), first, first + static_cast<difference_type>(n));
+		first += static_cast<difference_type>(n);
+		count -= n;
+		m_size += n;
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <std::size_t OtherChunkSize, class OtherAllocator>
+void stable_vector<T, ChunkSize, Allocator>::append(const stable_vector<T, OtherChunkSize, OtherAllocator>& other)
+{
+	assert(static_cast<const void*>(&other) != this);
+
+	reserve(size() + other.size());
+	for (auto it = other.segment_begin(); it != other.segment_end(); ++it)
+	{
+		const auto s = *it;
+		append_span(s.data, s.size);
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <std::size_t OtherChunkSize, class OtherAllocator>
+void stable_vector<T, ChunkSize, Allocator>::append(stable_vector<T, OtherChunkSize, OtherAllocator>&& other)
+{
+	assert(static_cast<const void*>(&other) != this);
+
+	reserve(size() + other.size());
+	for (auto it = other.segment_begin(); it != other.segment_end(); ++it)
+	{
+		const auto s = *it;
+		append_span(std::make_move_iterator(s.data), s.size);
+	}
+	other.clear();
+}
+
+// Shard coalescing: when our tail chunk is full (or absent), the source's
+// chunks transfer by moving pointers — O(chunks), no element copies, and the
+// source's elements keep their addresses. A partial tail breaks chunk
+// alignment, so that case falls back to a span-wise bulk move of the
+// elements. The source's spare chunks and slabs come along either way:
+// spliced chunks may live in slab memory, which has to stay alive as long as
+// they do.
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::splice(__self&& other)
+{
+	assert(static_cast<const void*>(&other) != this);
+	assert(m_alloc == other.m_alloc);
+
+	// A front offset on the source misaligns its chunks, so they can't be
+	// re-pointed; only the destination's front may be offset.
+	if (likely_true((!m_last || m_last->size() == ChunkSize) && other.m_offset == 0))
+	{
+		for (chunk_ptr& chunk : other.m_chunks)
+		{
+			m_table.push_back(chunk->data());
+			m_chunks.emplace_back(std::move(chunk));
+		}
+
+		m_size += other.m_size;
+		if (!m_chunks.empty())
+		{
+			m_last = m_chunks.back().get();
+		}
+
+		other.m_chunks.clear();
+		other.m_table.clear();
+		other.m_size = 0;
+		other.m_last = nullptr;
+	}
+	else
+	{
+		append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+		other.clear();
+	}
+
+	for (chunk_ptr& chunk : other.m_spare)
+	{
+		m_spare.emplace_back(std::move(chunk));
+	}
+
+	m_uncommissioned.insert(m_uncommissioned.end(), other.m_uncommissioned.begin(), other.m_uncommissioned.end());
+	m_slabs.insert(m_slabs.end(), other.m_slabs.begin(), other.m_slabs.end());
+
+	other.m_spare.clear();
+	other.m_uncommissioned.clear();
+	other.m_slabs.clear();
+}
+
+// Single-pass iterators have no length to carve into spans up front.
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class InputIt>
+void stable_vector<T, ChunkSize, Allocator>::append_dispatch(InputIt first, InputIt last, std::input_iterator_tag)
+{
+	for (; first != last; ++first)
+	{
+		push_back(*first);
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::assign(size_type count, const T& value)
+{
+	clear();
+	append(count, value);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class InputIt, class>
+void stable_vector<T, ChunkSize, Allocator>::assign(InputIt first, InputIt last)
+{
+	clear();
+	append(first, last);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::assign(std::initializer_list<T> ilist)
+{
+	assign(ilist.begin(), ilist.end());
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::push_back(const T& t)
+{
+	stable_vector_count(++m_stats.push_backs);
+
+	chunk_type& chunk = last_chunk();
+	try
+	{
+		chunk.push_back(t);
+	}
+	catch (...)
+	{
+		rollback_chunk(chunk);
+		throw;
+	}
+
+	++m_size;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::push_back(T&& t)
+{
+	stable_vector_count(++m_stats.push_backs);
+
+	chunk_type& chunk = last_chunk();
+	try
+	{
+		chunk.push_back(std::move(t));
+	}
+	catch (...)
+	{
+		rollback_chunk(chunk);
+		throw;
+	}
+
+	++m_size;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
 template <class... Args>
-void stable_vector<T, ChunkSize>::emplace_back(Args&&... args)
+void stable_vector<T, ChunkSize, Allocator>::emplace_back(Args&&... args)
+{
+	stable_vector_count(++m_stats.push_backs);
+
+	chunk_type& chunk = last_chunk();
+	try
+	{
+		chunk.emplace_back(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		rollback_chunk(chunk);
+		throw;
+	}
+
+	++m_size;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::push_front(T value)
+{
+	if (empty())
+	{
+		push_back(std::move(value));
+		return;
+	}
+
+	if (m_offset == 0)
+	{
+		prepend_chunk();
+	}
+
+	// The slot above the new front is dead but alive, so this is a plain
+	// assignment — no construction, no shifting.
+	(*m_chunks.front())[m_offset - 1] = std::move(value);
+	--m_offset;
+	++m_size;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void stable_vector<T, ChunkSize, Allocator>::pop_front() noexcept
 {
-	last_chunk().emplace_back(std::forward<Args>(args)...);
+	++m_offset;
+	--m_size;
+
+	chunk_type& chunk = *m_chunks.front();
+	if (m_offset == chunk.size())
+	{
+		// Drained: destroy the whole chunk's elements (the popped prefix was
+		// kept alive until now) and recycle it.
+		chunk.clear();
+		m_spare.emplace_back(std::move(m_chunks.front()));
+		m_chunks.erase(m_chunks.begin());
+		m_table.erase(m_table.begin());
+		m_offset = 0;
+		m_last = m_chunks.empty() ? nullptr : m_chunks.back().get();
+	}
 }
 
-template <class T, std::size_t ChunkSize>
-typename stable_vector<T, ChunkSize>::reference
-stable_vector<T, ChunkSize>::operator[](size_type i)
+// Shifting stays chunk-local: one element ripples across each chunk boundary
+// (back of one chunk to the front of the next) and only the target chunk
+// shifts internally, so at most ChunkSize elements move per affected chunk.
+// Element values after pos shift over; use unordered_erase where addresses
+// must survive.
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::iterator
+stable_vector<T, ChunkSize, Allocator>::insert(const_iterator pos, T value)
 {
-	return (*m_chunks[i / ChunkSize])[i % ChunkSize];
+	const size_type index = static_cast<size_type>(pos - cbegin());
+
+	if (index == size())
+	{
+		push_back(std::move(value));
+		return {this, index};
+	}
+
+	if (m_chunks.back()->size() == ChunkSize)
+	{
+		add_chunk();
+	}
+
+	const size_type p = index + m_offset;
+	const size_type chunk_index = p / ChunkSize;
+	for (size_type c = m_chunks.size() - 1; c > chunk_index; --c)
+	{
+		chunk_type& prev = *m_chunks[c - 1];
+		m_chunks[c]->insert(m_chunks[c]->begin(), std::move(prev.back()));
+		prev.pop_back();
+	}
+
+	chunk_type& chunk = *m_chunks[chunk_index];
+	chunk.insert(chunk.begin() + static_cast<difference_type>(p % ChunkSize), std::move(value));
+	++m_size;
+
+	return {this, index};
 }
 
-template <class T, std::size_t ChunkSize>
-typename stable_vector<T, ChunkSize>::const_reference
-stable_vector<T, ChunkSize>::operator[](size_type i) const
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::iterator
+stable_vector<T, ChunkSize, Allocator>::erase(const_iterator pos)
+{
+	const size_type index = static_cast<size_type>(pos - cbegin());
+	const size_type p = index + m_offset;
+	const size_type chunk_index = p / ChunkSize;
+
+	chunk_type& chunk = *m_chunks[chunk_index];
+	chunk.erase(chunk.begin() + static_cast<difference_type>(p % ChunkSize));
+
+	for (size_type c = chunk_index + 1; c < m_chunks.size(); ++c)
+	{
+		chunk_type& prev = *m_chunks[c - 1];
+		chunk_type& current = *m_chunks[c];
+		prev.push_back(std::move(current.front()));
+		current.erase(current.begin());
+	}
+
+	--m_size;
+	if (m_chunks.back()->size() == (m_chunks.size() == 1 ? m_offset : 0))
+	{
+		m_chunks.back()->clear();
+		retire_last_chunk();
+		if (m_chunks.empty())
+		{
+			m_offset = 0;
+		}
+	}
+
+	return {this, index};
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::iterator
+stable_vector<T, ChunkSize, Allocator>::unordered_erase(const_iterator pos)
+{
+	const size_type index = static_cast<size_type>(pos - cbegin());
+
+	if (index + 1 != size())
+	{
+		(*this)[index] = std::move(back());
+	}
+
+	pop_back();
+	return {this, index};
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::reference
+stable_vector<T, ChunkSize, Allocator>::operator[](size_type i)
+{
+	const size_type p = i + m_offset;
+
+	stable_vector_count(++m_stats.index_accesses);
+	stable_vector_count(p / ChunkSize != m_stats_last_chunk ? ++m_stats.chunk_crossings : 0);
+	stable_vector_count(m_stats_last_chunk = p / ChunkSize);
+
+	return m_table[p / ChunkSize][p % ChunkSize];
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::const_reference
+stable_vector<T, ChunkSize, Allocator>::operator[](size_type i) const
 {
 	return const_cast<__self&>(*this)[i];
 }
 
-template <class T, std::size_t ChunkSize>
-typename stable_vector<T, ChunkSize>::reference
-stable_vector<T, ChunkSize>::at(size_type i)
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::reference
+stable_vector<T, ChunkSize, Allocator>::at(size_type i)
 {
 	if (likely_false(i >= size()))
 	{
@@ -300,10 +1552,245 @@ stable_vector<T, ChunkSize>::at(size_type i)
 	return operator[](i);
 }
 
-template <class T, std::size_t ChunkSize>
-typename stable_vector<T, ChunkSize>::const_reference
-stable_vector<T, ChunkSize>::at(size_type i) const
+template <class T, std::size_t ChunkSize, class Allocator>
+typename stable_vector<T, ChunkSize, Allocator>::const_reference
+stable_vector<T, ChunkSize, Allocator>::at(size_type i) const
 {
 	return const_cast<__self&>(*this).at(i);
 }
 
+template <class T, std::size_t ChunkSize, class Allocator>
+template <class OutputIt>
+OutputIt stable_vector<T, ChunkSize, Allocator>::gather(const size_type* indices, size_type count, OutputIt out) const
+{
+	// Enough in flight to cover a memory round trip without overrunning the
+	// miss buffers.
+	constexpr size_type batch_size = 16;
+
+	const_pointer addresses[batch_size];
+
+	for (size_type base = 0; base < count; base += batch_size)
+	{
+		const size_type n = std::min(batch_size, count - base);
+
+		for (size_type j = 0; j < n; ++j)
+		{
+			__builtin_prefetch(m_table.data() + (indices[base + j] + m_offset) / ChunkSize);
+		}
+
+		for (size_type j = 0; j < n; ++j)
+		{
+			assert(indices[base + j] < size());
+			const size_type p = indices[base + j] + m_offset;
+			addresses[j] = m_table[p / ChunkSize] + p % ChunkSize;
+			__builtin_prefetch(addresses[j]);
+		}
+
+		for (size_type j = 0; j < n; ++j)
+		{
+			*out++ = *addresses[j];
+		}
+	}
+
+	return out;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+bool stable_vector<T, ChunkSize, Allocator>::operator==(const __self& c) const
+{
+	if (size() != c.size())
+	{
+		return false;
+	}
+
+	// Front offsets misalign the chunk spans; compare element-wise then.
+	if (likely_false(m_offset != 0 || c.m_offset != 0))
+	{
+		return std::equal(cbegin(), cend(), c.cbegin());
+	}
+
+	for (size_type i = 0; i < m_size; i += ChunkSize)
+	{
+		const size_type n = std::min(ChunkSize, m_size - i);
+		if (!span_equal(m_table[i / ChunkSize], c.m_table[i / ChunkSize], n, memcmp_comparable{}))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Lexicographic, needing only operator< of T; the plain pointer loop lets
+// the compiler vectorize the common all-equal prefix.
+template <class T, std::size_t ChunkSize, class Allocator>
+bool stable_vector<T, ChunkSize, Allocator>::operator<(const __self& c) const
+{
+	if (likely_false(m_offset != 0 || c.m_offset != 0))
+	{
+		return std::lexicographical_compare(cbegin(), cend(), c.cbegin(), c.cend());
+	}
+
+	const size_type common = std::min(m_size, c.m_size);
+	for (size_type i = 0; i < common; i += ChunkSize)
+	{
+		const size_type n = std::min(ChunkSize, common - i);
+		const const_pointer a = m_table[i / ChunkSize];
+		const const_pointer b = c.m_table[i / ChunkSize];
+
+		for (size_type k = 0; k < n; ++k)
+		{
+			if (a[k] < b[k])
+			{
+				return true;
+			}
+
+			if (b[k] < a[k])
+			{
+				return false;
+			}
+		}
+	}
+
+	return m_size < c.m_size;
+}
+
+
+// A size-bucketed pool for stable_vector chunks: freed blocks go on a free
+// list and are handed back on the next allocation of the same size, so
+// steady-state grow/shrink churn does no system allocator calls. Share one
+// pool between containers of the same chunk type to recycle across instances;
+// the pool must outlive every container (and chunk) drawing from it.
+class chunk_pool
+{
+public:
+	chunk_pool() = default;
+
+	chunk_pool(const chunk_pool&) = delete;
+	chunk_pool& operator=(const chunk_pool&) = delete;
+
+	~chunk_pool() { release(); }
+
+	void* allocate(std::size_t bytes)
+	{
+		auto& blocks = m_free[bytes];
+		if (!blocks.empty())
+		{
+			void* block = blocks.back();
+			blocks.pop_back();
+			return block;
+		}
+
+		return ::operator new(bytes);
+	}
+
+	void deallocate(void* block, std::size_t bytes)
+	{
+		m_free[bytes].push_back(block);
+	}
+
+	// Returns cached blocks to the system allocator; outstanding allocations
+	// are unaffected.
+	void release()
+	{
+		for (auto& bucket : m_free)
+		{
+			for (void* block : bucket.second)
+			{
+				::operator delete(block);
+			}
+		}
+
+		m_free.clear();
+	}
+
+	std::size_t free_blocks() const
+	{
+		std::size_t count = 0;
+		for (const auto& bucket : m_free)
+		{
+			count += bucket.second.size();
+		}
+
+		return count;
+	}
+
+private:
+	std::unordered_map<std::size_t, std::vector<void*>> m_free;
+};
+
+template <class T>
+class chunk_pool_allocator
+{
+public:
+	using value_type = T;
+
+	explicit chunk_pool_allocator(chunk_pool& pool) noexcept :
+		m_pool(&pool)
+	{}
+
+	template <class U>
+	chunk_pool_allocator(const chunk_pool_allocator<U>& other) noexcept :
+		m_pool(other.m_pool)
+	{}
+
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(m_pool->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n)
+	{
+		m_pool->deallocate(p, n * sizeof(T));
+	}
+
+	bool operator==(const chunk_pool_allocator& other) const noexcept { return m_pool == other.m_pool; }
+	bool operator!=(const chunk_pool_allocator& other) const noexcept { return !operator==(other); }
+
+private:
+	template <class U>
+	friend class chunk_pool_allocator;
+
+	chunk_pool* m_pool;
+};
+
+// Cache-line-aligned chunk storage. std::allocator in C++14 only guarantees
+// alignof(std::max_align_t), and static_vector keeps its element storage at
+// offset zero, so allocating chunks at Alignment boundaries puts element 0 of
+// every chunk on a cache-line (or page) boundary and keeps chunk edges from
+// sharing a line with unrelated allocations. Memory is not touched here, so
+// page placement follows first touch: with reserve(), pages land on the NUMA
+// node of whichever thread writes them first.
+template <class T, std::size_t Alignment = 64>
+class aligned_allocator
+{
+public:
+	using value_type = T;
+
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+	template <class U>
+	struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+	aligned_allocator() = default;
+
+	template <class U>
+	aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+	T* allocate(std::size_t n)
+	{
+		void* block = nullptr;
+		if (::posix_memalign(&block, std::max(Alignment, alignof(T)), n * sizeof(T)) != 0)
+		{
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T*>(block);
+	}
+
+	void deallocate(T* p, std::size_t) { std::free(p); }
+
+	bool operator==(const aligned_allocator&) const noexcept { return true; }
+	bool operator!=(const aligned_allocator&) const noexcept { return false; }
+};
+
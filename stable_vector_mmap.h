@@ -0,0 +1,247 @@
+#pragma once
+
+#include "stable_vector.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File persistence for trivially copyable element types. save_to_file()
+// writes the elements as one flat run (chunks are already contiguous spans,
+// so this is a header plus one write per chunk), and mapped_stable_vector
+// opens such a file read-only via mmap: startup is O(1) and pages fault in
+// lazily, instead of an O(n) deserialize-and-push_back pass.
+
+struct stable_vector_file_header
+{
+	std::uint64_t magic;
+	std::uint64_t element_size;
+	std::uint64_t chunk_size;
+	std::uint64_t count;
+};
+
+constexpr const std::uint64_t stable_vector_file_magic = 0x3130564254535ull; // "SVTBV01"
+
+// Streaming serialization: the header plus one fwrite per chunk going out,
+// and chunks materialized with resize_default_init() and fread straight into
+// their element storage coming back — no per-element copies in either
+// direction. The on-disk layout is one flat run and doesn't depend on
+// ChunkSize, so a container may be read back with a different chunk size
+// than it was written with.
+template <class T, std::size_t ChunkSize, class Allocator>
+void serialize(const stable_vector<T, ChunkSize, Allocator>& v, std::FILE* file)
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+				  "serialize requires a trivially copyable element type");
+
+	const stable_vector_file_header header{stable_vector_file_magic, sizeof(T), ChunkSize, v.size()};
+
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	v.for_each_chunk([&](const T* data, std::size_t n)
+	{
+		ok = ok && std::fwrite(data, sizeof(T), n, file) == n;
+	});
+
+	if (!ok)
+	{
+		throw std::runtime_error("stable_vector: serialize failed");
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void deserialize(stable_vector<T, ChunkSize, Allocator>& v, std::FILE* file)
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+				  "deserialize requires a trivially copyable element type");
+
+	stable_vector_file_header header;
+	if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+		header.magic != stable_vector_file_magic ||
+		header.element_size != sizeof(T))
+	{
+		throw std::runtime_error("stable_vector: stream is not a compatible container image");
+	}
+
+	v.clear();
+	v.reserve(static_cast<std::size_t>(header.count));
+	v.resize_default_init(static_cast<std::size_t>(header.count));
+
+	bool ok = true;
+	v.for_each_chunk([&](T* data, std::size_t n)
+	{
+		ok = ok && std::fread(data, sizeof(T), n, file) == n;
+	});
+
+	if (!ok)
+	{
+		throw std::runtime_error("stable_vector: truncated container image");
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void save_to_file(const stable_vector<T, ChunkSize, Allocator>& v, const std::string& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		throw std::runtime_error("stable_vector: cannot open " + path + " for writing");
+	}
+
+	try
+	{
+		serialize(v, file);
+	}
+	catch (...)
+	{
+		std::fclose(file);
+		throw;
+	}
+
+	if (std::fclose(file) != 0)
+	{
+		throw std::runtime_error("stable_vector: failed writing " + path);
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void load_from_file(stable_vector<T, ChunkSize, Allocator>& v, const std::string& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		throw std::runtime_error("stable_vector: cannot open " + path);
+	}
+
+	try
+	{
+		deserialize(v, file);
+	}
+	catch (...)
+	{
+		std::fclose(file);
+		throw;
+	}
+
+	std::fclose(file);
+}
+
+// Read-only view of a saved container backed by a private file mapping. The
+// mapped data is flat, so access is plain pointer arithmetic; the chunk-span
+// API is kept shape-compatible with stable_vector for kernels written against
+// for_each_chunk. Element addresses are stable for the lifetime of the view.
+template <class T, std::size_t ChunkSize = 1024>
+class mapped_stable_vector
+{
+public:
+	using value_type = T;
+	using const_reference = const value_type&;
+	using const_pointer = const value_type*;
+	using const_iterator = const value_type*;
+	using size_type = std::size_t;
+
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+	static_assert(std::is_trivially_copyable<T>::value,
+				  "mapped_stable_vector requires a trivially copyable element type");
+
+	explicit mapped_stable_vector(const std::string& path)
+	{
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("stable_vector: cannot open " + path);
+		}
+
+		struct stat status;
+		if (::fstat(fd, &status) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("stable_vector: cannot stat " + path);
+		}
+
+		m_bytes = static_cast<std::size_t>(status.st_size);
+		void* map = ::mmap(nullptr, m_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+
+		if (map == MAP_FAILED)
+		{
+			throw std::runtime_error("stable_vector: cannot map " + path);
+		}
+
+		m_map = map;
+
+		const auto& header = *static_cast<const stable_vector_file_header*>(m_map);
+		if (m_bytes < sizeof(header) ||
+			header.magic != stable_vector_file_magic ||
+			header.element_size != sizeof(T) ||
+			header.chunk_size != ChunkSize ||
+			m_bytes - sizeof(header) < header.count * sizeof(T))
+		{
+			::munmap(m_map, m_bytes);
+			throw std::runtime_error("stable_vector: " + path + " is not a compatible container image");
+		}
+
+		m_data = reinterpret_cast<const T*>(static_cast<const char*>(m_map) + sizeof(header));
+		m_size = header.count;
+	}
+
+	mapped_stable_vector(const mapped_stable_vector&) = delete;
+	mapped_stable_vector& operator=(const mapped_stable_vector&) = delete;
+
+	~mapped_stable_vector()
+	{
+		if (m_map)
+		{
+			::munmap(m_map, m_bytes);
+		}
+	}
+
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	const_pointer data() const noexcept { return m_data; }
+
+	const_iterator begin() const noexcept { return m_data; }
+	const_iterator cbegin() const noexcept { return m_data; }
+
+	const_iterator end() const noexcept { return m_data + m_size; }
+	const_iterator cend() const noexcept { return m_data + m_size; }
+
+	const_reference front() const { return m_data[0]; }
+	const_reference back() const { return m_data[m_size - 1]; }
+
+	const_reference operator[](size_type i) const { return m_data[i]; }
+
+	const_reference at(size_type i) const
+	{
+		if (likely_false(i >= m_size))
+		{
+			throw std::out_of_range("mapped_stable_vector::at");
+		}
+
+		return m_data[i];
+	}
+
+	// Same shape as stable_vector::for_each_chunk; spans are ChunkSize long
+	// except the last.
+	template <class F>
+	void for_each_chunk(F&& f) const
+	{
+		for (size_type i = 0; i < m_size; i += ChunkSize)
+		{
+			f(m_data + i, std::min(ChunkSize, m_size - i));
+		}
+	}
+
+private:
+	void* m_map = nullptr;
+	std::size_t m_bytes = 0;
+	const T* m_data = nullptr;
+	size_type m_size = 0;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "stable_vector.h"
+
+#include <numa.h>
+
+// NUMA placement for chunk storage, as an allocator so it rides the same
+// extension point as chunk_pool_allocator: every chunk and slab the container
+// creates — add_chunk(), reserve() — goes through it. Chunks are at least a
+// page, so per-chunk placement is meaningful: bind the container an ingest
+// thread fills to the node its readers run on, or interleave a container
+// scanned from every node. libnuma allocations are page-aligned, which also
+// satisfies cache-line alignment.
+
+enum class numa_placement
+{
+	first_touch, // pages land on the node of the first thread to touch them
+	local,       // bind pages to the node of the allocating thread
+	bind,        // bind pages to a fixed node
+	interleave   // round-robin pages across all nodes
+};
+
+template <class T>
+class numa_allocator
+{
+public:
+	using value_type = T;
+
+	numa_allocator() = default;
+
+	explicit numa_allocator(numa_placement placement, int node = 0) noexcept :
+		m_placement(placement),
+		m_node(node)
+	{}
+
+	template <class U>
+	numa_allocator(const numa_allocator<U>& other) noexcept :
+		m_placement(other.m_placement),
+		m_node(other.m_node)
+	{}
+
+	T* allocate(std::size_t n)
+	{
+		const std::size_t bytes = n * sizeof(T);
+
+		// libnuma's allocators are undefined on machines without NUMA
+		// support; fall back to the system allocator there.
+		if (likely_false(::numa_available() < 0))
+		{
+			return static_cast<T*>(::operator new(bytes));
+		}
+
+		void* block = nullptr;
+		switch (m_placement)
+		{
+		case numa_placement::first_touch: block = ::numa_alloc(bytes); break;
+		case numa_placement::local:       block = ::numa_alloc_local(bytes); break;
+		case numa_placement::bind:        block = ::numa_alloc_onnode(bytes, m_node); break;
+		case numa_placement::interleave:  block = ::numa_alloc_interleaved(bytes); break;
+		}
+
+		if (!block)
+		{
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T*>(block);
+	}
+
+	void deallocate(T* p, std::size_t n)
+	{
+		if (likely_false(::numa_available() < 0))
+		{
+			::operator delete(p);
+			return;
+		}
+
+		::numa_free(p, n * sizeof(T));
+	}
+
+	bool operator==(const numa_allocator& other) const noexcept { return m_placement == other.m_placement && m_node == other.m_node; }
+	bool operator!=(const numa_allocator& other) const noexcept { return !operator==(other); }
+
+private:
+	template <class U>
+	friend class numa_allocator;
+
+	numa_placement m_placement = numa_placement::first_touch;
+	int m_node = 0;
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "stable_vector.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Parallel algorithms over stable_vector, sharded by chunk: every chunk is an
+// independent contiguous block, so workers claim chunks off a shared atomic
+// counter (dynamic scheduling — a thread finishing a short trailing chunk
+// immediately grabs the next one) and run a flat-array kernel per chunk.
+// Threads are spawned per call; with chunk-sized work items the spawn cost is
+// noise next to the per-chunk work these are meant for.
+
+// Applies f(segment, chunk_index) to every segment, claimed dynamically
+// across thread_count workers. Building block for the element-wise algorithms
+// below.
+template <class Container, class SegmentF>
+void parallel_for_each_segment(Container& v, SegmentF f, unsigned thread_count = std::thread::hardware_concurrency())
+{
+	std::vector<decltype(*v.segment_begin())> segments;
+	for (auto it = v.segment_begin(); it != v.segment_end(); ++it)
+	{
+		segments.push_back(*it);
+	}
+
+	if (thread_count < 2 || segments.size() < 2)
+	{
+		for (std::size_t i = 0; i < segments.size(); ++i)
+		{
+			f(segments[i], i);
+		}
+		return;
+	}
+
+	if (thread_count > segments.size())
+	{
+		thread_count = static_cast<unsigned>(segments.size());
+	}
+
+	std::atomic<std::size_t> next{0};
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < thread_count; ++t)
+	{
+		workers.emplace_back([&]
+		{
+			std::size_t i;
+			while ((i = next.fetch_add(1, std::memory_order_relaxed)) < segments.size())
+			{
+				f(segments[i], i);
+			}
+		});
+	}
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator, class F>
+void parallel_for_each(stable_vector<T, ChunkSize, Allocator>& v, F f, unsigned thread_count = std::thread::hardware_concurrency())
+{
+	using segment = typename stable_vector<T, ChunkSize, Allocator>::segment;
+	parallel_for_each_segment(v, [&f](const segment& s, std::size_t)
+	{
+		for (std::size_t i = 0; i < s.size; ++i)
+		{
+			f(s.data[i]);
+		}
+	}, thread_count);
+}
+
+template <class T, std::size_t ChunkSize, class Allocator, class F>
+void parallel_for_each(const stable_vector<T, ChunkSize, Allocator>& v, F f, unsigned thread_count = std::thread::hardware_concurrency())
+{
+	using const_segment = typename stable_vector<T, ChunkSize, Allocator>::const_segment;
+	parallel_for_each_segment(v, [&f](const const_segment& s, std::size_t)
+	{
+		for (std::size_t i = 0; i < s.size; ++i)
+		{
+			f(s.data[i]);
+		}
+	}, thread_count);
+}
+
+// out must already hold in.size() elements; since every chunk but the last is
+// full, the two containers' chunk boundaries line up and each worker writes
+// its own output span.
+template <class T, std::size_t ChunkSize, class Allocator, class U, class OutAllocator, class F>
+void parallel_transform(const stable_vector<T, ChunkSize, Allocator>& in,
+						stable_vector<U, ChunkSize, OutAllocator>& out,
+						F f,
+						unsigned thread_count = std::thread::hardware_concurrency())
+{
+	assert(in.size() == out.size());
+
+	std::vector<typename stable_vector<U, ChunkSize, OutAllocator>::segment> out_segments;
+	for (auto it = out.segment_begin(); it != out.segment_end(); ++it)
+	{
+		out_segments.push_back(*it);
+	}
+
+	using const_segment = typename stable_vector<T, ChunkSize, Allocator>::const_segment;
+	parallel_for_each_segment(in, [&](const const_segment& s, std::size_t chunk_index)
+	{
+		// A pop_front() offset on either container would break the span
+		// pairing.
+		assert(out_segments[chunk_index].size == s.size);
+
+		const auto& out_segment = out_segments[chunk_index];
+		for (std::size_t i = 0; i < s.size; ++i)
+		{
+			out_segment.data[i] = f(s.data[i]);
+		}
+	}, thread_count);
+}
+
+// op must be associative; each chunk folds to one partial (first element
+// seeded, no identity injected), partials then fold into init in chunk order.
+template <class T, std::size_t ChunkSize, class Allocator, class U, class BinaryOp>
+U parallel_reduce(const stable_vector<T, ChunkSize, Allocator>& v,
+				  U init,
+				  BinaryOp op,
+				  unsigned thread_count = std::thread::hardware_concurrency())
+{
+	const auto& cv = v;
+	std::size_t chunks = 0;
+	for (auto it = cv.segment_begin(); it != cv.segment_end(); ++it)
+	{
+		++chunks;
+	}
+
+	std::vector<U> partials(chunks);
+
+	using const_segment = typename stable_vector<T, ChunkSize, Allocator>::const_segment;
+	parallel_for_each_segment(cv, [&](const const_segment& s, std::size_t chunk_index)
+	{
+		U partial = static_cast<U>(s.data[0]);
+		for (std::size_t i = 1; i < s.size; ++i)
+		{
+			partial = op(partial, s.data[i]);
+		}
+		partials[chunk_index] = partial;
+	}, thread_count);
+
+	U result = init;
+	for (const auto& partial : partials)
+	{
+		result = op(result, partial);
+	}
+
+	return result;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "stable_vector.h"
+
+// Slot map over stable_vector for long-lived references with slot reuse.
+// Elements live in chunked slots whose addresses never move; erase() frees
+// the slot onto an intrusive free list (the next-free index is stored in the
+// dead slot's value storage) and insert() reuses freed slots before growing,
+// so a long-running process with churn stays at high-water-mark memory
+// instead of growing without bound. Handles carry the slot's generation —
+// odd while live, bumped on every insert and erase — so a stale handle to a
+// reused slot is detected instead of aliasing the new occupant.
+template <class T, std::size_t ChunkSize = 1024, class Allocator = std::allocator<T>>
+class slot_map
+{
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using size_type = std::size_t;
+
+	struct handle
+	{
+		size_type index;
+		size_type generation;
+
+		bool operator==(const handle& h) const { return index == h.index && generation == h.generation; }
+		bool operator!=(const handle& h) const { return !operator==(h); }
+	};
+
+	slot_map() = default;
+
+	slot_map(const slot_map&) = delete;
+	slot_map& operator=(const slot_map&) = delete;
+
+	~slot_map() { clear(); }
+
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	handle insert(const T& value) { return emplace(value); }
+	handle insert(T&& value)      { return emplace(std::move(value)); }
+
+	template <class... Args>
+	handle emplace(Args&&... args)
+	{
+		size_type index;
+
+		if (m_free_head != npos)
+		{
+			index = m_free_head;
+			slot& s = m_slots[index];
+
+			// The free link shares storage with the value: a throwing
+			// constructor may have scribbled over it, so restore the link
+			// before rethrowing or the next emplace would chase garbage.
+			const size_type next = s.next_free();
+			try
+			{
+				::new (s.value()) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				s.next_free() = next;
+				throw;
+			}
+
+			m_free_head = next;
+			++s.generation;
+		}
+		else
+		{
+			index = m_slots.size();
+			m_slots.emplace_back();
+			slot& s = m_slots.back();
+
+			try
+			{
+				::new (s.value()) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				s.next_free() = m_free_head;
+				m_free_head = index;
+				throw;
+			}
+
+			++s.generation;
+		}
+
+		++m_size;
+		return {index, m_slots[index].generation};
+	}
+
+	void erase(handle h)
+	{
+		if (likely_false(!contains(h)))
+		{
+			throw std::out_of_range("slot_map::erase");
+		}
+
+		slot& s = m_slots[h.index];
+		s.value()->~T();
+		++s.generation;
+		s.next_free() = m_free_head;
+		m_free_head = h.index;
+		--m_size;
+	}
+
+	bool contains(handle h) const noexcept
+	{
+		return h.index < m_slots.size() && m_slots[h.index].generation == h.generation && (h.generation & 1) != 0;
+	}
+
+	// nullptr for stale or never-issued handles.
+	pointer find(handle h) noexcept { return contains(h) ? m_slots[h.index].value() : nullptr; }
+	const_pointer find(handle h) const noexcept { return const_cast<slot_map&>(*this).find(h); }
+
+	reference operator[](handle h)
+	{
+		assert(contains(h));
+		return *m_slots[h.index].value();
+	}
+
+	const_reference operator[](handle h) const { return const_cast<slot_map&>(*this)[h]; }
+
+	reference at(handle h)
+	{
+		if (likely_false(!contains(h)))
+		{
+			throw std::out_of_range("slot_map::at");
+		}
+
+		return *m_slots[h.index].value();
+	}
+
+	const_reference at(handle h) const { return const_cast<slot_map&>(*this).at(h); }
+
+	// Invokes f on every live element, in slot (not insertion) order.
+	template <class F>
+	void for_each(F&& f)
+	{
+		m_slots.for_each_chunk([&](slot* data, std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				if ((data[i].generation & 1) != 0)
+				{
+					f(*data[i].value());
+				}
+			}
+		});
+	}
+
+	template <class F>
+	void for_each(F&& f) const
+	{
+		const_cast<slot_map&>(*this).for_each([&](reference value) { f(static_cast<const_reference>(value)); });
+	}
+
+	void clear()
+	{
+		for_each([](reference value) { value.~T(); });
+		m_slots.clear();
+		m_free_head = npos;
+		m_size = 0;
+	}
+
+private:
+	static constexpr const size_type npos = std::numeric_limits<size_type>::max();
+
+	struct slot
+	{
+		typename std::aligned_storage<
+			(sizeof(T) > sizeof(size_type) ? sizeof(T) : sizeof(size_type)),
+			(alignof(T) > alignof(size_type) ? alignof(T) : alignof(size_type))>::type storage;
+		size_type generation = 0; // odd = live; bumped on insert and erase
+
+		T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+		size_type& next_free() noexcept { return *reinterpret_cast<size_type*>(&storage); }
+	};
+
+	using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+
+	stable_vector<slot, ChunkSize, slot_allocator> m_slots;
+	size_type m_free_head = npos;
+	size_type m_size = 0;
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "stable_vector.h"
+
+#include <tuple>
+
+// Structure-of-arrays companion: each described member of T lives in its own
+// stable_vector column, so a scan that touches two fields of an 11-field
+// struct streams two tight arrays instead of pulling whole structs through
+// the cache. Columns grow in lockstep and inherit the chunk layout, so every
+// field keeps per-element address stability.
+//
+// Describe T's members by specializing soa_members:
+//
+//	template <>
+//	struct soa_members<order>
+//	{
+//		static constexpr auto value = std::make_tuple(&order::price, &order::quantity);
+//	};
+//	constexpr decltype(soa_members<order>::value) soa_members<order>::value; // C++14 odr
+template <class T>
+struct soa_members;
+
+template <class T, std::size_t ChunkSize = 1024>
+class stable_vector_soa
+{
+	using members_type = typename std::decay<decltype(soa_members<T>::value)>::type;
+
+	template <class P>
+	struct member_type;
+
+	template <class M>
+	struct member_type<M T::*> { using type = M; };
+
+	template <std::size_t I>
+	using member_pointer = typename std::tuple_element<I, members_type>::type;
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+
+	static constexpr const std::size_t field_count = std::tuple_size<members_type>::value;
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+	template <std::size_t I>
+	using column_type = stable_vector<typename member_type<member_pointer<I>>::type, ChunkSize>;
+
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	void push_back(const T& t)
+	{
+		push_back_fields(t, indices{});
+		++m_size;
+	}
+
+	void reserve(size_type new_capacity) { reserve_fields(new_capacity, indices{}); }
+
+	void clear()
+	{
+		clear_fields(indices{});
+		m_size = 0;
+	}
+
+	void pop_back()
+	{
+		pop_back_fields(indices{});
+		--m_size;
+	}
+
+	// Reassembles a whole element from the columns; a copy, not a reference,
+	// since the fields aren't adjacent in memory.
+	T operator[](size_type i) const { return gather(i, indices{}); }
+
+	T at(size_type i) const
+	{
+		if (likely_false(i >= m_size))
+		{
+			throw std::out_of_range("stable_vector_soa::at");
+		}
+
+		return operator[](i);
+	}
+
+	// The column of the I-th described member.
+	template <std::size_t I>
+	column_type<I>& field() { return std::get<I>(m_columns); }
+
+	template <std::size_t I>
+	const column_type<I>& field() const { return std::get<I>(m_columns); }
+
+	// The column of a member by pointer: v.field(&order::price). The member
+	// must be in the soa_members description.
+	template <class M>
+	stable_vector<M, ChunkSize>& field(M T::*ptr) { return field_search<M, 0>(ptr); }
+
+	template <class M>
+	const stable_vector<M, ChunkSize>& field(M T::*ptr) const { return const_cast<stable_vector_soa&>(*this).field(ptr); }
+
+private:
+	using indices = std::make_index_sequence<field_count>;
+
+	template <std::size_t... Is>
+	void push_back_fields(const T& t, std::index_sequence<Is...>)
+	{
+		std::size_t pushed = 0;
+		try
+		{
+			const int expand[] = {(std::get<Is>(m_columns).push_back(t.*std::get<Is>(soa_members<T>::value)), ++pushed, 0)...};
+			static_cast<void>(expand);
+		}
+		catch (...)
+		{
+			// Keep the columns in lockstep if a field copy throws.
+			rollback(pushed, indices{});
+			throw;
+		}
+	}
+
+	template <std::size_t... Is>
+	void rollback(std::size_t pushed, std::index_sequence<Is...>)
+	{
+		const int expand[] = {(Is < pushed ? std::get<Is>(m_columns).pop_back() : void(), 0)...};
+		static_cast<void>(expand);
+	}
+
+	template <std::size_t... Is>
+	void reserve_fields(size_type new_capacity, std::index_sequence<Is...>)
+	{
+		const int expand[] = {(std::get<Is>(m_columns).reserve(new_capacity), 0)...};
+		static_cast<void>(expand);
+	}
+
+	template <std::size_t... Is>
+	void clear_fields(std::index_sequence<Is...>)
+	{
+		const int expand[] = {(std::get<Is>(m_columns).clear(), 0)...};
+		static_cast<void>(expand);
+	}
+
+	template <std::size_t... Is>
+	void pop_back_fields(std::index_sequence<Is...>)
+	{
+		const int expand[] = {(std::get<Is>(m_columns).pop_back(), 0)...};
+		static_cast<void>(expand);
+	}
+
+	template <std::size_t... Is>
+	T gather(size_type i, std::index_sequence<Is...>) const
+	{
+		T t{};
+		const int expand[] = {(t.*std::get<Is>(soa_members<T>::value) = std::get<Is>(m_columns)[i], 0)...};
+		static_cast<void>(expand);
+		return t;
+	}
+
+	template <class M, std::size_t I, typename std::enable_if<(I < field_count), int>::type = 0>
+	stable_vector<M, ChunkSize>& field_search(M T::*ptr)
+	{
+		return field_check<M, I>(ptr, std::is_same<member_pointer<I>, M T::*>{});
+	}
+
+	template <class M, std::size_t I, typename std::enable_if<(I == field_count), int>::type = 0>
+	stable_vector<M, ChunkSize>& field_search(M T::*)
+	{
+		throw std::invalid_argument("stable_vector_soa: member is not in the soa_members description");
+	}
+
+	template <class M, std::size_t I>
+	stable_vector<M, ChunkSize>& field_check(M T::*ptr, std::true_type)
+	{
+		if (std::get<I>(soa_members<T>::value) == ptr)
+		{
+			return std::get<I>(m_columns);
+		}
+
+		return field_search<M, I + 1>(ptr);
+	}
+
+	template <class M, std::size_t I>
+	stable_vector<M, ChunkSize>& field_check(M T::*ptr, std::false_type)
+	{
+		return field_search<M, I + 1>(ptr);
+	}
+
+	template <class Seq>
+	struct column_tuple;
+
+	template <std::size_t... Is>
+	struct column_tuple<std::index_sequence<Is...>>
+	{
+		using type = std::tuple<column_type<Is>...>;
+	};
+
+	typename column_tuple<indices>::type m_columns;
+	size_type m_size = 0;
+};
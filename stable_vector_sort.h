@@ -0,0 +1,119 @@
+#pragma once
+
+#include "stable_vector_parallel.h"
+
+#include <functional>
+
+// Sorting tuned to the chunked layout. std::sort over the index iterators
+// pays the two-level addressing on every compare and swap; here each chunk is
+// sorted as a flat array (in parallel, one run per chunk) and the sorted runs
+// are then k-way merged. sort() reorders values in place — use sorted_view()
+// when resident T* references must stay pointed at the same values: it leaves
+// the container untouched and hands back a permutation of stable addresses.
+
+template <class T, std::size_t ChunkSize, class Allocator, class Compare>
+void sort(stable_vector<T, ChunkSize, Allocator>& v, Compare comp, unsigned thread_count = std::thread::hardware_concurrency())
+{
+	using segment = typename stable_vector<T, ChunkSize, Allocator>::segment;
+
+	if (v.size() < 2)
+	{
+		return;
+	}
+
+	// One sorted run during the k-way merge; runs are heap-ordered by their
+	// current front so the merge pops the global minimum each step.
+	struct merge_run
+	{
+		T* cur;
+		T* end;
+	};
+
+	std::vector<merge_run> runs;
+	parallel_for_each_segment(v, [&comp](const segment& s, std::size_t)
+	{
+		std::sort(s.data, s.data + s.size, comp);
+	}, thread_count);
+
+	for (auto it = v.segment_begin(); it != v.segment_end(); ++it)
+	{
+		const segment s = *it;
+		runs.push_back({s.data, s.data + s.size});
+	}
+
+	if (runs.size() < 2)
+	{
+		return;
+	}
+
+	// Merge the runs through a min-heap of run fronts into a flat scratch
+	// buffer, then move the merged order back chunk by chunk. O(n) extra
+	// space buys flat-array access for every compare and move; an in-place
+	// multiway merge would drag the two-level iterators back in.
+	const auto run_greater = [&comp](const merge_run& l, const merge_run& r)
+	{
+		return comp(*r.cur, *l.cur);
+	};
+
+	std::vector<T> merged;
+	merged.reserve(v.size());
+
+	std::make_heap(runs.begin(), runs.end(), run_greater);
+	while (!runs.empty())
+	{
+		std::pop_heap(runs.begin(), runs.end(), run_greater);
+		auto& run = runs.back();
+
+		merged.push_back(std::move(*run.cur));
+		if (++run.cur == run.end)
+		{
+			runs.pop_back();
+		}
+		else
+		{
+			std::push_heap(runs.begin(), runs.end(), run_greater);
+		}
+	}
+
+	T* src = merged.data();
+	for (auto it = v.segment_begin(); it != v.segment_end(); ++it)
+	{
+		const segment s = *it;
+		std::move(src, src + s.size, s.data);
+		src += s.size;
+	}
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+void sort(stable_vector<T, ChunkSize, Allocator>& v, unsigned thread_count = std::thread::hardware_concurrency())
+{
+	sort(v, std::less<T>(), thread_count);
+}
+
+// Non-mutating alternative to sort(): a permutation of the elements'
+// addresses in comp order. The container is untouched, so existing T*
+// references (and the view itself) stay valid until elements are erased.
+template <class T, std::size_t ChunkSize, class Allocator, class Compare>
+std::vector<const T*> sorted_view(const stable_vector<T, ChunkSize, Allocator>& v, Compare comp)
+{
+	std::vector<const T*> view;
+	view.reserve(v.size());
+
+	for (auto it = v.segment_begin(); it != v.segment_end(); ++it)
+	{
+		const auto s = *it;
+		for (std::size_t i = 0; i < s.size; ++i)
+		{
+			view.push_back(s.data + i);
+		}
+	}
+
+	std::sort(view.begin(), view.end(), [&comp](const T* l, const T* r) { return comp(*l, *r); });
+	return view;
+}
+
+template <class T, std::size_t ChunkSize, class Allocator>
+std::vector<const T*> sorted_view(const stable_vector<T, ChunkSize, Allocator>& v)
+{
+	return sorted_view(v, std::less<T>());
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "stable_vector.h"
+
+// Fixed-capacity, constexpr-friendly sibling of stable_vector for tables
+// whose contents are known at compile time. Storage is one inline array — no
+// chunk table, no allocator, no startup cost — so a table built in a
+// constexpr function lands in .rodata:
+//
+//	constexpr static_stable_vector<int, 256> squares = make_squares();
+//
+// The ChunkSize parameter only shapes the segment view: for_each_chunk() and
+// segment_begin()/segment_end() carve the array into ChunkSize spans so the
+// chunk-based algorithms (stable_vector_parallel.h, stable_vector_sort.h)
+// work unchanged.
+template <class T, std::size_t N, std::size_t ChunkSize = 1024>
+class static_stable_vector
+{
+	static_assert(std::is_default_constructible<T>::value,
+				  "static_stable_vector value-initializes its inline storage");
+
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using iterator = pointer;
+	using const_iterator = const_pointer;
+
+	static constexpr const std::size_t chunk_size = ChunkSize;
+	static constexpr const std::size_t static_capacity = N;
+
+	struct segment
+	{
+		const_pointer data;
+		size_type size;
+	};
+
+	template <class Segment>
+	struct segment_iterator_base
+	{
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Segment;
+		using reference = Segment;
+		using pointer = void;
+		using difference_type = std::ptrdiff_t;
+
+		constexpr segment_iterator_base(const_pointer data = nullptr, size_type index = 0, size_type size = 0) :
+			m_data(data),
+			m_index(index),
+			m_size(size)
+		{}
+
+		constexpr Segment operator*() const { return {m_data + m_index, std::min(ChunkSize, m_size - m_index)}; }
+
+		segment_iterator_base& operator++()   { m_index += ChunkSize; return *this; }
+		segment_iterator_base operator++(int) { auto it = *this; operator++(); return it; }
+
+		constexpr bool operator==(const segment_iterator_base& it) const { return m_index == it.m_index; }
+		constexpr bool operator!=(const segment_iterator_base& it) const { return !operator==(it); }
+
+	 private:
+		const_pointer m_data;
+		size_type m_index;
+		size_type m_size;
+	};
+
+	using const_segment_iterator = segment_iterator_base<segment>;
+
+	constexpr static_stable_vector() = default;
+
+	constexpr static_stable_vector(std::initializer_list<T> ilist) :
+		m_size(ilist.size())
+	{
+		size_type i = 0;
+		for (const T& t : ilist)
+		{
+			m_elements[i++] = t;
+		}
+	}
+
+	constexpr size_type size() const noexcept { return m_size; }
+	constexpr size_type max_size() const noexcept { return N; }
+	constexpr size_type capacity() const noexcept { return N; }
+	constexpr bool empty() const noexcept { return m_size == 0; }
+
+	constexpr void push_back(const T& t)
+	{
+		if (likely_false(m_size == N))
+		{
+			throw std::length_error("static_stable_vector::push_back");
+		}
+
+		m_elements[m_size++] = t;
+	}
+
+	constexpr void pop_back() { --m_size; }
+	constexpr void clear() { m_size = 0; }
+
+	constexpr reference operator[](size_type i) { return m_elements[i]; }
+	constexpr const_reference operator[](size_type i) const { return m_elements[i]; }
+
+	constexpr reference at(size_type i)
+	{
+		if (likely_false(i >= m_size))
+		{
+			throw std::out_of_range("static_stable_vector::at");
+		}
+
+		return m_elements[i];
+	}
+
+	constexpr const_reference at(size_type i) const
+	{
+		if (likely_false(i >= m_size))
+		{
+			throw std::out_of_range("static_stable_vector::at");
+		}
+
+		return m_elements[i];
+	}
+
+	constexpr reference front()             { return m_elements[0]; }
+	constexpr const_reference front() const { return m_elements[0]; }
+
+	constexpr reference back()             { return m_elements[m_size - 1]; }
+	constexpr const_reference back() const { return m_elements[m_size - 1]; }
+
+	constexpr iterator begin() noexcept { return m_elements; }
+	constexpr const_iterator begin() const noexcept { return m_elements; }
+	constexpr const_iterator cbegin() const noexcept { return begin(); }
+
+	constexpr iterator end() noexcept { return m_elements + m_size; }
+	constexpr const_iterator end() const noexcept { return m_elements + m_size; }
+	constexpr const_iterator cend() const noexcept { return end(); }
+
+	constexpr const_segment_iterator segment_begin() const noexcept { return {m_elements, 0, m_size}; }
+	constexpr const_segment_iterator segment_end() const noexcept { return {m_elements, (m_size + ChunkSize - 1) / ChunkSize * ChunkSize, m_size}; }
+
+	template <class ChunkF>
+	void for_each_chunk(ChunkF f) const
+	{
+		for (size_type i = 0; i < m_size; i += ChunkSize)
+		{
+			f(m_elements + i, std::min(ChunkSize, m_size - i));
+		}
+	}
+
+	constexpr bool operator==(const static_stable_vector& c) const
+	{
+		if (m_size != c.m_size)
+		{
+			return false;
+		}
+
+		for (size_type i = 0; i < m_size; ++i)
+		{
+			if (!(m_elements[i] == c.m_elements[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	constexpr bool operator!=(const static_stable_vector& c) const { return !operator==(c); }
+
+private:
+	T m_elements[N] {};
+	size_type m_size = 0;
+};
@@ -1,12 +1,25 @@
 #include "stable_vector.h"
+#include "small_stable_vector.h"
+#include "static_stable_vector.h"
+#include "concurrent_stable_vector.h"
+#include "single_writer_stable_vector.h"
+#include "stable_vector_parallel.h"
+#include "stable_vector_sort.h"
+#include "stable_vector_mmap.h"
+#include "stable_vector_slot_map.h"
+#include "stable_vector_soa.h"
+
+#ifdef STABLE_VECTOR_HAVE_NUMA
+#include "stable_vector_numa.h"
+#endif
 
 #include <boost/noncopyable.hpp>
-#include <boost/container/stable_vector.hpp>
 #include <gtest/gtest.h>
 
 #include <list>
 #include <vector>
-#include <chrono>
+#include <thread>
+#include <algorithm>
 
 struct A
 {
@@ -284,6 +297,887 @@ TEST(stable_vector, reserve)
 	ASSERT_EQ(48, v2.capacity());
 }
 
+static int g_allocations = 0;
+
+template <class T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	counting_allocator() = default;
+
+	template <class U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T* allocate(std::size_t n)
+	{
+		++g_allocations;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+	bool operator==(const counting_allocator&) const { return true; }
+	bool operator!=(const counting_allocator&) const { return false; }
+};
+
+TEST(stable_vector, reserve_single_allocation)
+{
+	g_allocations = 0;
+	stable_vector<int, 4, counting_allocator<int>> v;
+
+	v.reserve(100);
+	ASSERT_EQ(v.capacity(), 100);
+	EXPECT_EQ(g_allocations, 1);
+
+	for (int i = 0; i < 100; ++i)
+		v.push_back(i);
+
+	EXPECT_EQ(g_allocations, 1);
+	ASSERT_EQ(v.size(), 100);
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(v[i], i);
+}
+
+TEST(stable_vector, shrink_to_fit_releases_unused_reservation)
+{
+	stable_vector<int, 4> v;
+	v.reserve(40);
+	ASSERT_EQ(v.capacity(), 40);
+
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 0);
+
+	v.reserve(40);
+	v.push_back(1);
+	v.shrink_to_fit();
+	ASSERT_EQ(v.size(), 1);
+	ASSERT_EQ(v[0], 1);
+}
+
+TEST(stable_vector, append_count)
+{
+	stable_vector<int, 4> v = {1, 2};
+	v.append(7, 3);
+
+	ASSERT_EQ(v.size(), 9);
+	ASSERT_EQ(v[1], 2);
+	ASSERT_EQ(v[2], 3);
+	ASSERT_EQ(v[8], 3);
+}
+
+TEST(stable_vector, append_range)
+{
+	std::vector<int> src = {3, 4, 5, 6, 7, 8, 9};
+	stable_vector<int, 4> v = {1, 2};
+	v.append(src.begin(), src.end());
+
+	ASSERT_EQ(v.size(), 9);
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(v[i], i + 1);
+}
+
+TEST(stable_vector, append_input_iterator)
+{
+	std::list<int> src = {3, 4, 5};
+	stable_vector<int, 2> v = {1, 2};
+	v.append(src.begin(), src.end());
+
+	ASSERT_EQ(v.size(), 5);
+	ASSERT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 1 + 2 + 3 + 4 + 5);
+}
+
+TEST(stable_vector, assign)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+	v.assign(3, 1);
+	ASSERT_EQ(v.size(), 3);
+	ASSERT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 3);
+
+	std::vector<int> src = {1, 2, 3, 4, 5};
+	v.assign(src.begin(), src.end());
+	ASSERT_EQ(v.size(), 5);
+	ASSERT_EQ(v[4], 5);
+
+	v.assign({1, 2});
+	ASSERT_EQ(v.size(), 2);
+	ASSERT_EQ(v[1], 2);
+}
+
+TEST(stable_vector, insert)
+{
+	stable_vector<int, 4> v = {1, 2, 4, 5, 6, 7, 8, 9};
+
+	auto it = v.insert(v.cbegin() + 2, 3);
+	ASSERT_EQ(*it, 3);
+	ASSERT_EQ(v.size(), 9);
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(v[i], i + 1);
+
+	v.insert(v.cbegin(), 0);
+	ASSERT_EQ(v.front(), 0);
+	ASSERT_EQ(v.back(), 9);
+
+	v.insert(v.cend(), 10);
+	ASSERT_EQ(v.back(), 10);
+	ASSERT_EQ(v.size(), 11);
+
+	stable_vector<int, 4> empty_v;
+	empty_v.insert(empty_v.cbegin(), 1);
+	ASSERT_EQ(empty_v.size(), 1);
+}
+
+TEST(stable_vector, erase)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 42, 4, 5, 6, 7, 8, 9};
+
+	auto it = v.erase(v.cbegin() + 3);
+	ASSERT_EQ(*it, 4);
+	ASSERT_EQ(v.size(), 9);
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(v[i], i + 1);
+
+	v.erase(v.cbegin());
+	ASSERT_EQ(v.front(), 2);
+
+	v.erase(v.cend() - 1);
+	ASSERT_EQ(v.back(), 8);
+	ASSERT_EQ(v.size(), 7);
+}
+
+TEST(stable_vector, unordered_erase)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	auto* ref = &v[1];
+
+	auto it = v.unordered_erase(v.cbegin() + 4);
+	ASSERT_EQ(*it, 9);
+	ASSERT_EQ(v.size(), 8);
+	ASSERT_TRUE(ref == &v[1]);
+	ASSERT_EQ(v[1], 2);
+
+	v.unordered_erase(v.cend() - 1);
+	ASSERT_EQ(v.size(), 7);
+	ASSERT_EQ(v.back(), 7);
+}
+
+TEST(stable_vector, pop_back)
+{
+	stable_vector<int, 2> v = {1, 2, 3};
+	const auto initial_capacity = v.capacity();
+
+	v.pop_back();
+	ASSERT_EQ(v.size(), 2);
+	ASSERT_EQ(v.back(), 2);
+
+	v.pop_back();
+	v.pop_back();
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(v.capacity(), initial_capacity);
+}
+
+TEST(stable_vector, clear_retains_chunks)
+{
+	stable_vector<CallCounter<>, 4> v(9);
+	const auto initial_capacity = v.capacity();
+	CallCounter<>::reset_counters();
+
+	v.clear();
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(v.size(), 0);
+	EXPECT_EQ(9, CallCounter<>::destructions);
+	ASSERT_EQ(v.capacity(), initial_capacity);
+
+	v.resize(9);
+	ASSERT_EQ(v.size(), 9);
+	ASSERT_EQ(v.capacity(), initial_capacity);
+}
+
+TEST(stable_vector, resize)
+{
+	stable_vector<int, 4> v;
+
+	v.resize(6, 7);
+	ASSERT_EQ(v.size(), 6);
+	ASSERT_EQ(v[5], 7);
+
+	v.resize(9);
+	ASSERT_EQ(v.size(), 9);
+	ASSERT_EQ(v[5], 7);
+	ASSERT_EQ(v[8], 0);
+
+	v.resize(2);
+	ASSERT_EQ(v.size(), 2);
+	ASSERT_EQ(v.back(), 7);
+
+	v.resize(0);
+	ASSERT_TRUE(v.empty());
+}
+
+TEST(stable_vector, shrink_to_fit)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	v.resize(2);
+	ASSERT_EQ(v.capacity(), 12);
+
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 4);
+	ASSERT_EQ(v.size(), 2);
+	ASSERT_EQ(v[1], 2);
+}
+
+TEST(stable_vector, stats)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+
+	EXPECT_EQ(v.stats().push_backs, 10);
+	EXPECT_EQ(v.stats().chunks_added, 3);
+	EXPECT_EQ(v.stats().chunk_allocations, 3);
+	EXPECT_EQ(v.stats().peak_chunks, 3);
+
+	// Sequential scan: one crossing per chunk. Random-ish jumps: one each.
+	for (int i = 0; i < 10; ++i)
+		v[static_cast<std::size_t>(i)] = i;
+	EXPECT_EQ(v.stats().index_accesses, 10);
+	EXPECT_EQ(v.stats().chunk_crossings, 3);
+
+	v[9] = 0; // still in the chunk the scan ended on
+	v[0] = 0; // jump back
+	EXPECT_EQ(v.stats().chunk_crossings, 4);
+
+	// Recycled chunks don't count as allocations.
+	v.clear();
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+	EXPECT_EQ(v.stats().chunks_added, 6);
+	EXPECT_EQ(v.stats().chunk_allocations, 3);
+}
+
+TEST(stable_vector, pop_front)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+
+	v.pop_front();
+	v.pop_front();
+
+	ASSERT_EQ(v.size(), 8);
+	ASSERT_EQ(v.front(), 2);
+	for (int i = 0; i < 8; ++i)
+		ASSERT_EQ(v[i], i + 2);
+
+	// Iteration, chunk spans and comparisons see only the live window.
+	int expected = 2;
+	for (int i : v)
+		ASSERT_EQ(i, expected++);
+
+	std::size_t total = 0;
+	v.for_each_chunk([&](const int*, std::size_t n) { total += n; });
+	ASSERT_EQ(total, 8);
+
+	ASSERT_EQ(v, (stable_vector<int, 4>{2, 3, 4, 5, 6, 7, 8, 9}));
+
+	// Draining the first chunk recycles it.
+	v.pop_front();
+	v.pop_front();
+	ASSERT_EQ(v.front(), 4);
+	ASSERT_EQ(v.capacity(), 12);
+
+	while (!v.empty())
+		v.pop_front();
+	ASSERT_TRUE(v.empty());
+
+	v.push_back(42);
+	ASSERT_EQ(v.front(), 42);
+	ASSERT_EQ(v.back(), 42);
+}
+
+TEST(stable_vector, push_front)
+{
+	stable_vector<int, 4> v;
+	v.push_front(3);
+	v.push_front(2);
+
+	for (int i = 0; i < 6; ++i)
+		v.pop_front(), v.push_front(i); // reuse drained slots
+
+	ASSERT_EQ(v.size(), 2);
+
+	for (int i = 6; i < 12; ++i)
+		v.push_front(i); // grow fresh front chunks
+
+	ASSERT_EQ(v.size(), 8);
+	ASSERT_EQ(v.front(), 11);
+	ASSERT_EQ(v, (stable_vector<int, 4>{11, 10, 9, 8, 7, 6, 5, 3}));
+}
+
+TEST(stable_vector, sliding_window)
+{
+	stable_vector<int, 4> v;
+	const int* stable_address = nullptr;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		v.push_back(i);
+		if (i == 50)
+			stable_address = &v[v.size() - 1];
+		if (v.size() > 10)
+			v.pop_front();
+	}
+
+	ASSERT_EQ(v.size(), 10);
+	ASSERT_EQ(v.front(), 90);
+	ASSERT_EQ(v.back(), 99);
+
+	// Memory is bounded: drained chunks recycle through the spare list.
+	EXPECT_LE(v.capacity(), 24);
+	EXPECT_TRUE(stable_address != nullptr);
+}
+
+TEST(stable_vector, pop_front_with_non_trivial_elements)
+{
+	stable_vector<std::string, 4> v = {"a", "b", "c", "d", "e", "f"};
+
+	v.pop_front();
+	v.push_front("x");
+	v.pop_front();
+	v.pop_front();
+
+	ASSERT_EQ(v, (stable_vector<std::string, 4>{"c", "d", "e", "f"}));
+
+	const stable_vector<std::string, 4> copy(v);
+	ASSERT_EQ(copy, v);
+	ASSERT_EQ(copy.front(), "c");
+}
+
+TEST(stable_vector, splice_repoints_chunks)
+{
+	stable_vector<int, 4> a;
+	for (int i = 0; i < 8; ++i)
+		a.push_back(i);
+
+	stable_vector<int, 4> b;
+	for (int i = 8; i < 18; ++i)
+		b.push_back(i);
+	const int* spliced_address = &b[0];
+
+	a.splice(std::move(b));
+
+	ASSERT_EQ(a.size(), 18);
+	ASSERT_TRUE(b.empty());
+	for (int i = 0; i < 18; ++i)
+		ASSERT_EQ(a[i], i);
+
+	// The aligned path re-points chunks, so spliced elements keep addresses.
+	EXPECT_TRUE(spliced_address == &a[8]);
+
+	a.push_back(18);
+	ASSERT_EQ(a.back(), 18);
+}
+
+TEST(stable_vector, splice_into_partial_tail)
+{
+	stable_vector<std::string, 4> a = {"a", "b", "c"};
+	stable_vector<std::string, 4> b = {"d", "e", "f", "g", "h"};
+
+	a.splice(std::move(b));
+
+	ASSERT_EQ(a, (stable_vector<std::string, 4>{"a", "b", "c", "d", "e", "f", "g", "h"}));
+	ASSERT_TRUE(b.empty());
+}
+
+TEST(stable_vector, splice_adopts_slabs)
+{
+	stable_vector<int, 4> a;
+	a.push_back(-1);
+	a.push_back(-2);
+	a.push_back(-3);
+	a.push_back(-4);
+
+	{
+		stable_vector<int, 4> b;
+		b.reserve(40);
+		for (int i = 0; i < 20; ++i)
+			b.push_back(i);
+
+		a.splice(std::move(b));
+		ASSERT_EQ(b.capacity(), 0);
+	} // b dies; its slab must live on in a
+
+	ASSERT_EQ(a.size(), 24);
+	ASSERT_EQ(a.capacity(), 40 + 4);
+	for (int i = 0; i < 20; ++i)
+		ASSERT_EQ(a[i + 4], i);
+
+	// Unused reservation was adopted too: growth proceeds without allocating.
+	for (int i = 0; i < 16; ++i)
+		a.push_back(i);
+	ASSERT_EQ(a.size(), 40);
+	ASSERT_EQ(a.capacity(), 44);
+}
+
+TEST(stable_vector, less_than)
+{
+	using sv = stable_vector<int, 4>;
+
+	EXPECT_LT((sv{1, 2, 3}), (sv{1, 2, 4}));
+	EXPECT_LT((sv{1, 2, 3}), (sv{1, 2, 3, 0}));
+	EXPECT_FALSE((sv{1, 2, 3}) < (sv{1, 2, 3}));
+	EXPECT_GT((sv{2}), (sv{1, 9, 9}));
+	EXPECT_LE((sv{}), (sv{}));
+	EXPECT_GE((sv{0}), (sv{}));
+
+	// Cross a chunk boundary so the per-chunk walk is exercised.
+	sv a, b;
+	for (int i = 0; i < 10; ++i)
+	{
+		a.push_back(i);
+		b.push_back(i);
+	}
+	b.push_back(0);
+	EXPECT_LT(a, b);
+	b[9] = -1;
+	EXPECT_GT(a, b);
+}
+
+TEST(stable_vector, equal_non_trivial_elements)
+{
+	using sv = stable_vector<std::string, 2>;
+
+	EXPECT_EQ((sv{"a", "b", "c"}), (sv{"a", "b", "c"}));
+	EXPECT_NE((sv{"a", "b", "c"}), (sv{"a", "b", "d"}));
+	EXPECT_LT((sv{"a", "b"}), (sv{"a", "c"}));
+}
+
+TEST(stable_vector, writer)
+{
+	stable_vector<int, 4> v;
+	v.push_back(-1);
+
+	{
+		auto w = v.writer(10);
+		for (int i = 0; i < 10; ++i)
+			w.push_back(i);
+	}
+
+	ASSERT_EQ(v.size(), 11);
+	ASSERT_EQ(v[0], -1);
+	for (int i = 0; i < 10; ++i)
+		ASSERT_EQ(v[i + 1], i);
+
+	v.push_back(99);
+	ASSERT_EQ(v.back(), 99);
+}
+
+TEST(stable_vector, writer_returns_unwritten_slots)
+{
+	stable_vector<int, 4> v;
+
+	{
+		auto w = v.writer(10);
+		for (int i = 0; i < 3; ++i)
+			w.push_back(i);
+	}
+
+	ASSERT_EQ(v.size(), 3);
+	ASSERT_EQ(v, (stable_vector<int, 4>{0, 1, 2}));
+	ASSERT_EQ(v.capacity(), 12);
+
+	{
+		auto w = v.writer(0);
+		static_cast<void>(w);
+	}
+	ASSERT_EQ(v.size(), 3);
+}
+
+TEST(stable_vector, writer_single_allocation)
+{
+	g_allocations = 0;
+	stable_vector<int, 4, counting_allocator<int>> v;
+
+	auto w = v.writer(100);
+	for (int i = 0; i < 100; ++i)
+		w.push_back(i);
+
+	EXPECT_EQ(g_allocations, 1);
+	ASSERT_EQ(v.size(), 100);
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(v[i], i);
+}
+
+TEST(stable_vector, snapshot_shares_full_chunks)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+
+	const auto s = v.snapshot();
+	ASSERT_EQ(s.size(), 10);
+	for (int i = 0; i < 10; ++i)
+		ASSERT_EQ(s[i], i);
+
+	// Full chunks are shared by pointer, the partial tail is a copy.
+	EXPECT_TRUE(&s[0] == &v[0]);
+	EXPECT_TRUE(&s[7] == &v[7]);
+	EXPECT_TRUE(&s[8] != &v[8]);
+}
+
+TEST(stable_vector, snapshot_unaffected_by_appends)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 6; ++i)
+		v.push_back(i);
+
+	const auto s = v.snapshot();
+	for (int i = 6; i < 20; ++i)
+		v.push_back(i);
+
+	ASSERT_EQ(s.size(), 6);
+	ASSERT_EQ(s.front(), 0);
+	ASSERT_EQ(s.back(), 5);
+	ASSERT_THROW(s.at(6), std::out_of_range);
+
+	int expected = 0;
+	std::size_t chunks = 0;
+	s.for_each_chunk([&](const int* data, std::size_t n)
+	{
+		++chunks;
+		for (std::size_t i = 0; i < n; ++i)
+			ASSERT_EQ(data[i], expected++);
+	});
+	ASSERT_EQ(chunks, 2);
+	ASSERT_EQ(expected, 6);
+}
+
+TEST(stable_vector_sort, sort_across_chunks)
+{
+	stable_vector<int, 8> v;
+	for (int i = 0; i < 100; ++i)
+		v.push_back((i * 37) % 100);
+	v.push_back(50); // a duplicate, to exercise merge stability on ties
+
+	sort(v);
+
+	ASSERT_EQ(v.size(), 101);
+	ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+	ASSERT_EQ(v.front(), 0);
+	ASSERT_EQ(v.back(), 99);
+	ASSERT_EQ(std::count(v.begin(), v.end(), 50), 2);
+}
+
+TEST(stable_vector_sort, sort_with_comparator)
+{
+	stable_vector<int, 4> v{3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+	sort(v, std::greater<int>());
+
+	ASSERT_TRUE(std::is_sorted(v.begin(), v.end(), std::greater<int>()));
+	ASSERT_EQ(v.front(), 9);
+	ASSERT_EQ(v.back(), 1);
+}
+
+TEST(stable_vector_sort, sorted_view_leaves_addresses_alone)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 20; ++i)
+		v.push_back(19 - i);
+
+	const int* resident = &v[7]; // holds 12
+	const auto view = sorted_view(v);
+
+	ASSERT_EQ(view.size(), 20);
+	for (int i = 0; i < 20; ++i)
+		ASSERT_EQ(*view[static_cast<std::size_t>(i)], i);
+
+	// The container itself is untouched.
+	ASSERT_EQ(v[0], 19);
+	ASSERT_EQ(resident, &v[7]);
+	ASSERT_EQ(*resident, 12);
+	ASSERT_EQ(view[12], resident);
+}
+
+TEST(stable_vector, gather)
+{
+	stable_vector<int, 8> v;
+	for (int i = 0; i < 100; ++i)
+		v.push_back(i * 10);
+
+	// A scattered index stream crossing chunks, longer than one prefetch
+	// batch, with repeats.
+	std::vector<std::size_t> indices;
+	for (std::size_t i = 0; i < 50; ++i)
+		indices.push_back((i * 61) % 100);
+	indices.push_back(0);
+	indices.push_back(99);
+	indices.push_back(0);
+
+	std::vector<int> out(indices.size());
+	const auto end = v.gather(indices.data(), indices.size(), out.begin());
+
+	ASSERT_EQ(end, out.end());
+	for (std::size_t i = 0; i < indices.size(); ++i)
+		ASSERT_EQ(out[i], static_cast<int>(indices[i]) * 10);
+}
+
+TEST(stable_vector, gather_after_pop_front)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 20; ++i)
+		v.push_back(i);
+	v.pop_front();
+	v.pop_front();
+
+	const std::size_t indices[] = {0, 5, 17};
+	int out[3];
+	v.gather(indices, 3, out);
+
+	EXPECT_EQ(out[0], 2);
+	EXPECT_EQ(out[1], 7);
+	EXPECT_EQ(out[2], 19);
+}
+
+TEST(stable_vector, append_across_chunk_sizes)
+{
+	stable_vector<int, 4> staging;
+	for (int i = 0; i < 50; ++i)
+		staging.push_back(i);
+
+	stable_vector<int, 16> store;
+	store.push_back(-1);
+	store.append(staging);
+
+	ASSERT_EQ(store.size(), 51);
+	ASSERT_EQ(store[0], -1);
+	for (int i = 0; i < 50; ++i)
+		ASSERT_EQ(store[static_cast<std::size_t>(i) + 1], i);
+	ASSERT_EQ(staging.size(), 50);
+
+	// And back down into smaller chunks.
+	stable_vector<int, 4> back;
+	back.append(store);
+	ASSERT_EQ(back.size(), 51);
+	ASSERT_EQ(back.back(), 49);
+}
+
+TEST(stable_vector, append_across_chunk_sizes_moves)
+{
+	stable_vector<std::string, 4> staging;
+	for (int i = 0; i < 10; ++i)
+		staging.push_back(std::string(100, static_cast<char>('a' + i)));
+
+	stable_vector<std::string, 16> store;
+	store.append(std::move(staging));
+
+	ASSERT_TRUE(staging.empty());
+	ASSERT_EQ(store.size(), 10);
+	for (int i = 0; i < 10; ++i)
+		ASSERT_EQ(store[static_cast<std::size_t>(i)], std::string(100, static_cast<char>('a' + i)));
+}
+
+TEST(stable_vector, ctor_across_chunk_sizes)
+{
+	stable_vector<int, 4> staging;
+	for (int i = 0; i < 20; ++i)
+		staging.push_back(i);
+
+	stable_vector<int, 16> store(staging);
+	ASSERT_EQ(store.size(), 20);
+	for (int i = 0; i < 20; ++i)
+		ASSERT_EQ(store[static_cast<std::size_t>(i)], i);
+}
+
+TEST(stable_vector, compact_packs_chunks_into_one_slab)
+{
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 30; ++i)
+		v.push_back(i);
+	for (int i = 0; i < 10; ++i)
+		v.pop_back(); // leaves spare chunks behind
+
+	v.compact();
+
+	ASSERT_EQ(v.size(), 20);
+	for (int i = 0; i < 20; ++i)
+		ASSERT_EQ(v[i], i);
+	ASSERT_EQ(v.capacity(), 20);
+
+	// All chunks were commissioned from one slab: consecutive chunk storage
+	// at a fixed stride.
+	std::vector<const int*> chunk_data;
+	v.for_each_chunk([&](const int* data, std::size_t) { chunk_data.push_back(data); });
+	ASSERT_EQ(chunk_data.size(), 5);
+	for (std::size_t i = 1; i < chunk_data.size(); ++i)
+		ASSERT_EQ(chunk_data[i] - chunk_data[i - 1], chunk_data[1] - chunk_data[0]);
+}
+
+TEST(stable_vector, compact_with_huge_page_hint)
+{
+	stable_vector<std::string, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(std::to_string(i));
+
+	v.compact(page_hint::huge);
+
+	ASSERT_EQ(v.size(), 10);
+	for (int i = 0; i < 10; ++i)
+		ASSERT_EQ(v[static_cast<std::size_t>(i)], std::to_string(i));
+}
+
+TEST(stable_vector, nothrow_move_operations)
+{
+	using v_type = stable_vector<int>;
+	EXPECT_TRUE(std::is_nothrow_move_constructible<v_type>::value);
+	EXPECT_TRUE(std::is_nothrow_move_assignable<v_type>::value);
+	EXPECT_TRUE(noexcept(std::declval<v_type&>().swap(std::declval<v_type&>())));
+	EXPECT_TRUE(noexcept(std::declval<v_type&>().pop_back()));
+	EXPECT_TRUE(noexcept(std::declval<v_type&>().pop_front()));
+	EXPECT_TRUE(noexcept(std::declval<v_type&>().clear()));
+}
+
+namespace
+{
+
+struct ThrowOnCopy
+{
+	ThrowOnCopy(int value) : m_value(value) {}
+
+	ThrowOnCopy(const ThrowOnCopy& other) :
+		m_value(other.m_value)
+	{
+		if (armed)
+			throw std::runtime_error("ThrowOnCopy");
+	}
+
+	ThrowOnCopy& operator=(const ThrowOnCopy&) = default;
+
+	static bool armed;
+	int m_value;
+};
+
+bool ThrowOnCopy::armed = false;
+
+} // namespace
+
+TEST(stable_vector, push_back_strong_guarantee)
+{
+	stable_vector<ThrowOnCopy, 4> v;
+	for (int i = 0; i < 4; ++i)
+		v.push_back(ThrowOnCopy{i});
+
+	// The next push_back opens a fresh chunk; a throwing element copy must
+	// retire it again and leave the container as it was.
+	ThrowOnCopy::armed = true;
+	EXPECT_THROW(v.push_back(ThrowOnCopy{4}), std::runtime_error);
+	ThrowOnCopy::armed = false;
+
+	ASSERT_EQ(v.size(), 4);
+	ASSERT_EQ(v.back().m_value, 3);
+
+	// Still usable: the retired chunk is recycled by the next append.
+	v.push_back(ThrowOnCopy{4});
+	ASSERT_EQ(v.size(), 5);
+	ASSERT_EQ(v.back().m_value, 4);
+}
+
+TEST(stable_vector, copy_assignment_strong_guarantee)
+{
+	stable_vector<ThrowOnCopy, 4> v;
+	for (int i = 0; i < 6; ++i)
+		v.push_back(ThrowOnCopy{i});
+
+	stable_vector<ThrowOnCopy, 4> target;
+	target.push_back(ThrowOnCopy{100});
+
+	ThrowOnCopy::armed = true;
+	EXPECT_THROW(target = v, std::runtime_error);
+	ThrowOnCopy::armed = false;
+
+	ASSERT_EQ(target.size(), 1);
+	ASSERT_EQ(target.front().m_value, 100);
+
+	target = v;
+	ASSERT_EQ(target.size(), 6);
+	ASSERT_EQ(target.back().m_value, 5);
+}
+
+TEST(stable_vector_allocator, aligned_chunks)
+{
+	stable_vector<int, 16, aligned_allocator<int>> v;
+	for (int i = 0; i < 100; ++i)
+		v.push_back(i);
+
+	v.for_each_chunk([](const int* data, std::size_t)
+	{
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % 64, 0);
+	});
+
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(v[i], i);
+}
+
+#ifdef STABLE_VECTOR_HAVE_NUMA
+TEST(stable_vector_allocator, numa_placement)
+{
+	stable_vector<int, 16, numa_allocator<int>> v{numa_allocator<int>{numa_placement::interleave}};
+	for (int i = 0; i < 100; ++i)
+		v.push_back(i);
+
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(v[i], i);
+
+	v.clear();
+	v.shrink_to_fit();
+}
+#endif
+
+TEST(stable_vector_allocator, chunk_pool_recycles)
+{
+	using pooled_vector = stable_vector<int, 4, chunk_pool_allocator<int>>;
+
+	chunk_pool pool;
+	{
+		pooled_vector v{chunk_pool_allocator<int>(pool)};
+		v.append(9, 1);
+		ASSERT_EQ(pool.free_blocks(), 0);
+	}
+	ASSERT_EQ(pool.free_blocks(), 3);
+
+	pooled_vector v{chunk_pool_allocator<int>(pool)};
+	v.append(9, 2);
+	ASSERT_EQ(pool.free_blocks(), 0);
+	ASSERT_EQ(v.size(), 9);
+	ASSERT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 18);
+}
+
+TEST(stable_vector_allocator, chunk_pool_copy_shares_pool)
+{
+	using pooled_vector = stable_vector<int, 4, chunk_pool_allocator<int>>;
+
+	chunk_pool pool;
+	pooled_vector v{chunk_pool_allocator<int>(pool)};
+	v.append(5, 1);
+
+	pooled_vector v2(v);
+	ASSERT_TRUE(v == v2);
+	ASSERT_TRUE(v2.get_allocator() == v.get_allocator());
+}
+
+TEST(stable_vector_allocator, chunk_pool_release)
+{
+	chunk_pool pool;
+	{
+		stable_vector<int, 4, chunk_pool_allocator<int>> v{chunk_pool_allocator<int>(pool)};
+		v.append(9, 1);
+	}
+	ASSERT_EQ(pool.free_blocks(), 3);
+
+	pool.release();
+	ASSERT_EQ(pool.free_blocks(), 0);
+}
+
 TEST(stable_vector_multiple_chunks, init)
 {
 	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -330,6 +1224,49 @@ TEST(stable_vector_multiple_chunks, iterator)
 	ASSERT_TRUE(it == v.begin() + 1);
 }
 
+TEST(stable_vector_segments, for_each_chunk)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+	int sum = 0;
+	std::size_t chunks = 0;
+	v.for_each_chunk([&](const int* data, std::size_t n)
+	{
+		++chunks;
+		for (std::size_t i = 0; i < n; ++i)
+			sum += data[i];
+	});
+
+	ASSERT_EQ(chunks, 3);
+	ASSERT_EQ(sum, 45);
+}
+
+TEST(stable_vector_segments, segment_iteration)
+{
+	stable_vector<int, 4> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	const auto& cv = v;
+
+	std::size_t total = 0;
+	for (auto it = cv.segment_begin(); it != cv.segment_end(); ++it)
+	{
+		auto s = *it;
+		ASSERT_TRUE(s.size <= 4);
+		total += s.size;
+	}
+
+	ASSERT_EQ(total, v.size());
+
+	auto s = *v.segment_begin();
+	s.data[0] = 42;
+	ASSERT_EQ(v[0], 42);
+}
+
+TEST(stable_vector_segments, empty)
+{
+	stable_vector<int> v;
+	ASSERT_TRUE(v.segment_begin() == v.segment_end());
+}
+
 TEST(stable_vector_iterator, empty)
 {
 	stable_vector<int> v;
@@ -373,47 +1310,541 @@ TEST(stable_vector_iterator, arithmetic)
 	ASSERT_TRUE(it == v.begin());
 }
 
-template <class ContainerT>
-int sum(const ContainerT& v)
+TEST(stable_vector_parallel, for_each)
 {
+	stable_vector<int, 16> v(1000, 1);
+	parallel_for_each(v, [](int& i) { i += 1; }, 4);
+
+	ASSERT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 2000);
+
 	int sum = 0;
-	auto start = std::chrono::high_resolution_clock::now();
-	for (const auto& i : v)
+	const auto& cv = v;
+	parallel_for_each(cv, [&sum](const int&) {}, 1);
+	(void)sum;
+}
+
+TEST(stable_vector_parallel, transform)
+{
+	stable_vector<int, 16> in;
+	for (int i = 0; i < 1000; ++i)
+		in.push_back(i);
+
+	stable_vector<int, 16> out(in.size());
+	parallel_transform(in, out, [](int i) { return i * 2; }, 4);
+
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_EQ(out[i], i * 2);
+}
+
+TEST(stable_vector_parallel, reduce)
+{
+	stable_vector<int, 16> v;
+	for (int i = 1; i <= 1000; ++i)
+		v.push_back(i);
+
+	const int sum = parallel_reduce(v, 0, std::plus<int>(), 4);
+	ASSERT_EQ(sum, 1000 * 1001 / 2);
+
+	stable_vector<int, 16> empty_v;
+	ASSERT_EQ(parallel_reduce(empty_v, 42, std::plus<int>(), 4), 42);
+}
+
+TEST(stable_vector_mmap, save_and_map_roundtrip)
+{
+	const std::string path = testing::TempDir() + "stable_vector_mmap_test.bin";
+
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 9; ++i)
+		v.push_back(i);
+
+	save_to_file(v, path);
+
+	mapped_stable_vector<int, 4> m(path);
+	ASSERT_EQ(m.size(), 9);
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(m[i], i);
+
+	ASSERT_EQ(std::accumulate(m.cbegin(), m.cend(), 0), 36);
+	ASSERT_EQ(m.front(), 0);
+	ASSERT_EQ(m.back(), 8);
+	ASSERT_THROW(m.at(9), std::out_of_range);
+
+	std::size_t chunks = 0;
+	std::size_t total = 0;
+	m.for_each_chunk([&](const int*, std::size_t n)
 	{
-		sum += i;
-	}
-	auto end = std::chrono::high_resolution_clock::now();
+		++chunks;
+		total += n;
+	});
+	ASSERT_EQ(chunks, 3);
+	ASSERT_EQ(total, 9);
+
+	::unlink(path.c_str());
+}
+
+TEST(stable_vector_mmap, rejects_incompatible_image)
+{
+	const std::string path = testing::TempDir() + "stable_vector_mmap_test.bin";
+
+	stable_vector<int, 4> v = {1, 2, 3};
+	save_to_file(v, path);
+
+	using wrong_chunk_size = mapped_stable_vector<int, 8>;
+	ASSERT_THROW(wrong_chunk_size{path}, std::runtime_error);
+
+	ASSERT_THROW(mapped_stable_vector<int>("/nonexistent/stable_vector.bin"), std::runtime_error);
+
+	::unlink(path.c_str());
+}
+
+TEST(stable_vector_mmap, serialize_roundtrip)
+{
+	const std::string path = testing::TempDir() + "stable_vector_serialize_test.bin";
+
+	stable_vector<int, 4> v;
+	for (int i = 0; i < 11; ++i)
+		v.push_back(i);
+	save_to_file(v, path);
+
+	// The flat layout doesn't depend on ChunkSize; read back with another.
+	stable_vector<int, 8> w{-1, -1};
+	load_from_file(w, path);
+
+	ASSERT_EQ(w.size(), 11);
+	for (int i = 0; i < 11; ++i)
+		ASSERT_EQ(w[i], i);
+
+	::unlink(path.c_str());
+}
 
-	std::cout << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "ms elapsed" << std::endl;
-	return sum;
+TEST(stable_vector_mmap, deserialize_rejects_bad_stream)
+{
+	const std::string path = testing::TempDir() + "stable_vector_serialize_test.bin";
+
+	stable_vector<int, 4> v = {1, 2, 3};
+	save_to_file(v, path);
+
+	// Wrong element size.
+	stable_vector<double, 4> d;
+	ASSERT_THROW(load_from_file(d, path), std::runtime_error);
+
+	// Truncated payload.
+	::truncate(path.c_str(), sizeof(stable_vector_file_header) + sizeof(int));
+	stable_vector<int, 4> w;
+	ASSERT_THROW(load_from_file(w, path), std::runtime_error);
+
+	::unlink(path.c_str());
+}
+
+struct soa_order
+{
+	double price;
+	int quantity;
+	char side;
+};
+
+template <>
+struct soa_members<soa_order>
+{
+	static constexpr auto value = std::make_tuple(&soa_order::price, &soa_order::quantity, &soa_order::side);
+};
+constexpr decltype(soa_members<soa_order>::value) soa_members<soa_order>::value;
+
+TEST(stable_vector_soa, push_back_and_gather)
+{
+	stable_vector_soa<soa_order, 4> v;
+	ASSERT_TRUE(v.empty());
+
+	for (int i = 0; i < 10; ++i)
+		v.push_back({i * 1.5, i, i % 2 ? 'B' : 'S'});
+
+	ASSERT_EQ(v.size(), 10);
+
+	const soa_order o = v[3];
+	EXPECT_EQ(o.price, 4.5);
+	EXPECT_EQ(o.quantity, 3);
+	EXPECT_EQ(o.side, 'B');
+
+	ASSERT_THROW(v.at(10), std::out_of_range);
+}
+
+TEST(stable_vector_soa, field_projection)
+{
+	stable_vector_soa<soa_order, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back({i * 1.0, i, 'B'});
+
+	// Narrow scans walk one column without touching the others.
+	double total = 0;
+	for (double price : v.field<0>())
+		total += price;
+	ASSERT_EQ(total, 45.0);
+
+	int quantities = 0;
+	for (int quantity : v.field(&soa_order::quantity))
+		quantities += quantity;
+	ASSERT_EQ(quantities, 45);
+
+	ASSERT_EQ(&v.field(&soa_order::price), &v.field<0>());
+}
+
+TEST(stable_vector_soa, per_field_stability)
+{
+	stable_vector_soa<soa_order, 4> v;
+	v.push_back({1.0, 1, 'B'});
+
+	const double* price = &v.field<0>()[0];
+	const int* quantity = &v.field<1>()[0];
+
+	for (int i = 0; i < 1000; ++i)
+		v.push_back({0.0, 0, 'S'});
+
+	ASSERT_TRUE(price == &v.field<0>()[0]);
+	ASSERT_TRUE(quantity == &v.field<1>()[0]);
+
+	v.pop_back();
+	ASSERT_EQ(v.size(), 1000);
+	v.clear();
+	ASSERT_TRUE(v.empty());
+}
+
+TEST(slot_map, insert_and_lookup)
+{
+	slot_map<std::string, 4> m;
+	ASSERT_TRUE(m.empty());
+
+	const auto a = m.insert("a");
+	const auto b = m.insert("b");
+
+	ASSERT_EQ(m.size(), 2);
+	ASSERT_EQ(m[a], "a");
+	ASSERT_EQ(m.at(b), "b");
+	ASSERT_TRUE(m.contains(a));
+	ASSERT_NE(a, b);
+}
+
+TEST(slot_map, erase_invalidates_handle_and_reuses_slot)
+{
+	slot_map<int, 4> m;
+
+	const auto a = m.insert(1);
+	const auto b = m.insert(2);
+	m.erase(a);
+
+	ASSERT_EQ(m.size(), 1);
+	ASSERT_FALSE(m.contains(a));
+	ASSERT_TRUE(m.find(a) == nullptr);
+	ASSERT_THROW(m.at(a), std::out_of_range);
+	ASSERT_THROW(m.erase(a), std::out_of_range);
+
+	// The freed slot is reused under a new generation; the stale handle
+	// must not alias the new occupant.
+	const auto c = m.insert(3);
+	ASSERT_EQ(c.index, a.index);
+	ASSERT_NE(c.generation, a.generation);
+	ASSERT_FALSE(m.contains(a));
+	ASSERT_EQ(m[c], 3);
+	ASSERT_EQ(m[b], 2);
+}
+
+TEST(slot_map, throwing_constructor_on_reuse_keeps_free_list_intact)
+{
+	slot_map<ThrowOnCopy, 4> m;
+
+	const auto a = m.insert(ThrowOnCopy{1});
+	const auto b = m.insert(ThrowOnCopy{2});
+	m.erase(a);
+	m.erase(b);
+
+	// The failed copy writes into the freed slot's storage before throwing,
+	// clobbering the free link; emplace must restore it.
+	ThrowOnCopy::armed = true;
+	ASSERT_THROW(m.insert(ThrowOnCopy{3}), std::runtime_error);
+	ThrowOnCopy::armed = false;
+
+	ASSERT_EQ(m.size(), 0);
+	ASSERT_FALSE(m.contains(a));
+	ASSERT_FALSE(m.contains(b));
+
+	// Both freed slots are still reachable through the free list.
+	const auto c = m.insert(ThrowOnCopy{3});
+	const auto d = m.insert(ThrowOnCopy{4});
+	ASSERT_EQ(m.size(), 2);
+	ASSERT_EQ(m[c].m_value, 3);
+	ASSERT_EQ(m[d].m_value, 4);
+	ASSERT_EQ(c.index + d.index, a.index + b.index);
+}
+
+TEST(slot_map, addresses_stay_stable_across_growth)
+{
+	slot_map<int, 4> m;
+
+	const auto h = m.insert(42);
+	const int* address = m.find(h);
+
+	std::vector<slot_map<int, 4>::handle> handles;
+	for (int i = 0; i < 1000; ++i)
+		handles.push_back(m.insert(i));
+
+	ASSERT_TRUE(address == m.find(h));
+	ASSERT_EQ(m[h], 42);
+
+	// Churn: erase every other element, then refill without growing.
+	for (std::size_t i = 0; i < handles.size(); i += 2)
+		m.erase(handles[i]);
+
+	for (int i = 0; i < 500; ++i)
+		m.insert(-i);
+
+	ASSERT_EQ(m.size(), 1001);
+	ASSERT_TRUE(address == m.find(h));
+
+	int live = 0;
+	m.for_each([&](const int&) { ++live; });
+	ASSERT_EQ(live, 1001);
+}
+
+TEST(small_stable_vector, inline_elements_avoid_allocation)
+{
+	g_allocations = 0;
+	small_stable_vector<int, 4, 8, counting_allocator<int>> v{1, 2, 3, 4};
+
+	ASSERT_EQ(v.size(), 4);
+	EXPECT_EQ(g_allocations, 0);
+
+	v.push_back(5);
+	EXPECT_EQ(g_allocations, 1);
+	ASSERT_EQ(v.size(), 5);
+	for (int i = 0; i < 5; ++i)
+		ASSERT_EQ(v[i], i + 1);
+}
+
+TEST(small_stable_vector, inline_elements_stay_stable_across_overflow)
+{
+	small_stable_vector<int, 2, 4> v{1, 2};
+	int* first = &v[0];
+
+	for (int i = 3; i <= 20; ++i)
+		v.push_back(i);
+
+	ASSERT_TRUE(first == &v[0]);
+	ASSERT_EQ(v.size(), 20);
+	ASSERT_EQ(v.front(), 1);
+	ASSERT_EQ(v.back(), 20);
+}
+
+TEST(small_stable_vector, pop_back_shrinks_into_inline_buffer)
+{
+	small_stable_vector<int, 2, 4> v{1, 2, 3};
+
+	v.pop_back();
+	ASSERT_EQ(v.back(), 2);
+
+	v.pop_back();
+	ASSERT_EQ(v.back(), 1);
+
+	v.pop_back();
+	ASSERT_TRUE(v.empty());
+}
+
+TEST(small_stable_vector, iteration)
+{
+	small_stable_vector<int, 3, 4> v{1, 2, 3, 4, 5, 6, 7};
+	const auto& cv = v;
+
+	int expected = 1;
+	for (int i : cv)
+		ASSERT_EQ(i, expected++);
+
+	std::fill(v.begin(), v.end(), 9);
+	ASSERT_EQ(v, (small_stable_vector<int, 3, 4>{9, 9, 9, 9, 9, 9, 9}));
+	ASSERT_NE(v, (small_stable_vector<int, 3, 4>{9, 9, 9}));
+
+	ASSERT_THROW(v.at(7), std::out_of_range);
 }
 
-static std::size_t ElementsCount = 10000000;
+namespace
+{
+
+constexpr static_stable_vector<int, 8> make_squares()
+{
+	static_stable_vector<int, 8> v;
+	for (int i = 0; i < 8; ++i)
+		v.push_back(i * i);
+	return v;
+}
+
+// Built entirely at compile time; no runtime construction.
+constexpr auto g_squares = make_squares();
+static_assert(g_squares.size() == 8, "");
+static_assert(g_squares[3] == 9, "");
+static_assert(g_squares.back() == 49, "");
+static_assert(!g_squares.empty(), "");
+
+constexpr static_stable_vector<int, 4> g_primes = {2, 3, 5, 7};
+static_assert(g_primes.size() == 4, "");
+static_assert(g_primes[2] == 5, "");
+
+} // namespace
+
+TEST(static_stable_vector, compile_time_table)
+{
+	ASSERT_EQ(g_squares.size(), 8);
+	for (std::size_t i = 0; i < g_squares.size(); ++i)
+		ASSERT_EQ(g_squares[i], static_cast<int>(i * i));
+	ASSERT_EQ(g_squares, make_squares());
+	ASSERT_THROW(g_squares.at(8), std::out_of_range);
+}
+
+TEST(static_stable_vector, runtime_use)
+{
+	static_stable_vector<int, 16, 4> v;
+	for (int i = 0; i < 10; ++i)
+		v.push_back(i);
+
+	ASSERT_EQ(v.size(), 10);
+	ASSERT_EQ(v.capacity(), 16);
+
+	static_stable_vector<int, 2> full = {1, 2};
+	ASSERT_THROW(full.push_back(3), std::length_error);
 
-TEST(stable_vector_iterator, performance)
+	v.pop_back();
+	ASSERT_EQ(v.back(), 8);
+
+	// Segment view carves the inline array into ChunkSize spans, like the
+	// chunked containers.
+	std::size_t chunks = 0;
+	int expected = 0;
+	v.for_each_chunk([&](const int* data, std::size_t n)
+	{
+		++chunks;
+		for (std::size_t i = 0; i < n; ++i)
+			ASSERT_EQ(data[i], expected++);
+	});
+	ASSERT_EQ(chunks, 3);
+
+	chunks = 0;
+	for (auto it = v.segment_begin(); it != v.segment_end(); ++it)
+		++chunks;
+	ASSERT_EQ(chunks, 3);
+}
+
+TEST(concurrent_stable_vector, single_thread)
 {
-	stable_vector<int, 4096> v(ElementsCount, 1);
-	int s = sum(v);
-	EXPECT_EQ(ElementsCount, s);
+	concurrent_stable_vector<int, 4> v;
+	ASSERT_TRUE(v.empty());
+
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(v.push_back(i), i);
+
+	ASSERT_EQ(v.size(), 9);
+	for (int i = 0; i < 9; ++i)
+		ASSERT_EQ(v[i], i);
 }
 
-TEST(boost_stable_vector_iterator, performance)
+TEST(concurrent_stable_vector, multi_producer)
 {
-	boost::container::stable_vector<int> v(ElementsCount, 1);
-	int s = sum(v);
-	EXPECT_EQ(ElementsCount, s);
+	constexpr int producers = 8;
+	constexpr int per_producer = 20000;
+
+	concurrent_stable_vector<int, 16> v;
+	int* stable_ref = nullptr;
+
+	std::vector<std::thread> workers;
+	for (int p = 0; p < producers; ++p)
+	{
+		workers.emplace_back([&v, p]
+		{
+			for (int i = 0; i < per_producer; ++i)
+				v.push_back(p * per_producer + i);
+		});
+	}
+
+	while (v.empty())
+		std::this_thread::yield();
+	stable_ref = &v[0];
+	const int stable_value = v[0];
+
+	for (auto& worker : workers)
+		worker.join();
+
+	ASSERT_EQ(v.size(), producers * per_producer);
+	ASSERT_TRUE(stable_ref == &v[0]);
+	ASSERT_EQ(stable_value, v[0]);
+
+	std::vector<int> values;
+	for (std::size_t i = 0; i < v.size(); ++i)
+		values.push_back(v[i]);
+	std::sort(values.begin(), values.end());
+
+	for (int i = 0; i < producers * per_producer; ++i)
+		ASSERT_EQ(values[i], i);
 }
 
-TEST(list_iterator, performance)
+TEST(single_writer_stable_vector, single_thread)
 {
-	std::list<int> v(ElementsCount, 1);
-	int s = sum(v);
-	EXPECT_EQ(ElementsCount, s);
+	single_writer_stable_vector<int, 4> v;
+	ASSERT_TRUE(v.empty());
+	ASSERT_TRUE(v.stable_prefix().empty());
+
+	for (int i = 0; i < 20; ++i)
+		v.push_back(i);
+
+	ASSERT_EQ(v.size(), 20);
+	ASSERT_EQ(v[7], 7);
+
+	const auto s = v.stable_prefix();
+	v.push_back(20); // appends don't touch an already taken prefix
+
+	ASSERT_EQ(s.size(), 20);
+	ASSERT_EQ(s.front(), 0);
+	ASSERT_EQ(s.back(), 19);
+
+	int expected = 0;
+	for (int value : s)
+		ASSERT_EQ(value, expected++);
+	ASSERT_EQ(expected, 20);
+
+	ASSERT_EQ(v.size(), 21);
+	ASSERT_EQ(v.container().size(), 21);
 }
 
-TEST(std_vector_iterator, performance)
+TEST(single_writer_stable_vector, reader_concurrent_with_appends)
 {
-	std::vector<int> v(10000000, 1);
-	int s = sum(v);
-	std::cout << s << std::endl;
+	constexpr int count = 50000;
+	single_writer_stable_vector<int, 16> v;
+
+	std::atomic<bool> done{false};
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; ++r)
+	{
+		readers.emplace_back([&v, &done]
+		{
+			std::size_t last_size = 0;
+			while (!done.load(std::memory_order_relaxed))
+			{
+				const auto s = v.stable_prefix();
+
+				// The published count never goes backwards and every
+				// published element reads consistently.
+				ASSERT_GE(s.size(), last_size);
+				last_size = s.size();
+
+				int expected = 0;
+				for (int value : s)
+					ASSERT_EQ(value, expected++);
+			}
+		});
+	}
+
+	for (int i = 0; i < count; ++i)
+		v.push_back(i);
+	done = true;
+
+	for (auto& reader : readers)
+		reader.join();
+
+	const auto s = v.stable_prefix();
+	ASSERT_EQ(s.size(), count);
+	ASSERT_EQ(s.back(), count - 1);
 }